@@ -6,28 +6,28 @@
  */
 
 
+#include "SSD1309.h"
+#ifndef SSD1309_SIM
 #include <xc.h>
+#else
+#include "delays.h"
+#endif
+#include "SSD1309_bus.h"
 #include <stdlib.h>
-#include "SSD1309.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
-#include <stdio.h>
 #include <stdarg.h>
-#include <stdio.h>
-
-#define CONTROL_PORT		PORTA
-#define CONTROL_PORT_CONF	TRISA
-#define DATA_PORT			PORTD
-#define DATA_PORT_CONF		TRISD
 
 #define PROGMEM /* empty */
 #define pgm_read_byte(x) (*(x))
 #define pgm_read_word(x) (*(x))
 #define pgm_read_float(x) (*(x))
 
+#define STATIC_ASSERT(cond, name)	typedef char static_assert_##name[(cond) ? 1 : -1]	// fails to compile if cond is false
+
 /*#############################################################################
 ###################################### fonts ##################################
 #############################################################################*/
@@ -259,64 +259,248 @@ static const char  bigDigit[15][26] =			// big 13x16 font
 };
 
 
-static void initInterface(void)
+static const UINT8 propFont[849] =			// proportional 5x7 font, the small font without empty columns
 {
+	0x00,0x00,						//   (  0)    - 0x20 Space
+	0x4F,							//   (  1)  ! - 0x21 Exclamation Mark
+	0x07,0x00,0x07,					//   (  2)  " - 0x22 Quotation Mark
+	0x14,0x7F,0x14,0x7F,0x14,		//   (  3)  # - 0x23 Number Sign
+	0x24,0x2A,0x7F,0x2A,0x12,		//   (  4)  $ - 0x24 Dollar Sign
+	0x23,0x13,0x08,0x64,0x62,		//   (  5)  % - 0x25 Percent Sign
+	0x36,0x49,0x55,0x22,0x50,		//   (  6)  & - 0x26 Ampersand
+	0x05,0x03,						//   (  7)  ' - 0x27 Apostrophe
+	0x1C,0x22,0x41,					//   (  8)  ( - 0x28 Left Parenthesis
+	0x41,0x22,0x1C,					//   (  9)  ) - 0x29 Right Parenthesis
+	0x14,0x08,0x3E,0x08,0x14,		//   ( 10)  * - 0x2A Asterisk
+	0x08,0x08,0x3E,0x08,0x08,		//   ( 11)  + - 0x2B Plus Sign
+	0x50,0x30,						//   ( 12)  , - 0x2C Comma
+	0x08,0x08,0x08,0x08,0x08,		//   ( 13)  - - 0x2D Hyphen-Minus
+	0x60,0x60,						//   ( 14)  . - 0x2E Point
+	0x20,0x10,0x08,0x04,0x02,		//   ( 15)  / - 0x2F Solidus
+	0x3E,0x51,0x49,0x45,0x3E,		//   ( 16)  0 - 0x30 Digit Zero
+	0x42,0x7F,0x40,					//   ( 17)  1 - 0x31 Digit One
+	0x42,0x61,0x51,0x49,0x46,		//   ( 18)  2 - 0x32 Digit Two
+	0x21,0x41,0x45,0x4B,0x31,		//   ( 19)  3 - 0x33 Digit Three
+	0x18,0x14,0x12,0x7F,0x10,		//   ( 20)  4 - 0x34 Digit Four
+	0x27,0x45,0x45,0x45,0x39,		//   ( 21)  5 - 0x35 Digit Five
+	0x3C,0x4A,0x49,0x49,0x30,		//   ( 22)  6 - 0x36 Digit Six
+	0x01,0x71,0x09,0x05,0x03,		//   ( 23)  7 - 0x37 Digit Seven
+	0x36,0x49,0x49,0x49,0x36,		//   ( 24)  8 - 0x38 Digit Eight
+	0x06,0x49,0x49,0x29,0x1E,		//   ( 25)  9 - 0x39 Digit Nine
+	0x36,0x36,						//   ( 26)  : - 0x3A Colon
+	0x56,0x36,						//   ( 27)  ; - 0x3B Semicolon
+	0x08,0x14,0x22,0x41,			//   ( 28)  < - 0x3C Less-Than Sign
+	0x14,0x14,0x14,0x14,0x14,		//   ( 29)  = - 0x3D Equals Sign
+	0x41,0x22,0x14,0x08,			//   ( 30)  > - 0x3E Greater-Than Sign
+	0x02,0x01,0x51,0x09,0x06,		//   ( 31)  ? - 0x3F Question Mark
+	0x32,0x49,0x79,0x41,0x3E,		//   ( 32)  @ - 0x40 Commercial At
+	0x7E,0x11,0x11,0x11,0x7E,		//   ( 33)  A - 0x41 Latin Capital Letter A
+	0x7F,0x49,0x49,0x49,0x36,		//   ( 34)  B - 0x42 Latin Capital Letter B
+	0x3E,0x41,0x41,0x41,0x22,		//   ( 35)  C - 0x43 Latin Capital Letter C
+	0x7F,0x41,0x41,0x22,0x1C,		//   ( 36)  D - 0x44 Latin Capital Letter D
+	0x7F,0x49,0x49,0x49,0x41,		//   ( 37)  E - 0x45 Latin Capital Letter E
+	0x7F,0x09,0x09,0x09,0x01,		//   ( 38)  F - 0x46 Latin Capital Letter F
+	0x3E,0x41,0x49,0x49,0x7A,		//   ( 39)  G - 0x47 Latin Capital Letter G
+	0x7F,0x08,0x08,0x08,0x7F,		//   ( 40)  H - 0x48 Latin Capital Letter H
+	0x41,0x7F,0x41,					//   ( 41)  I - 0x49 Latin Capital Letter I
+	0x20,0x40,0x41,0x3F,0x01,		//   ( 42)  J - 0x4A Latin Capital Letter J
+	0x7F,0x08,0x14,0x22,0x41,		//   ( 43)  K - 0x4B Latin Capital Letter K
+	0x7F,0x40,0x40,0x40,0x40,		//   ( 44)  L - 0x4C Latin Capital Letter L
+	0x7F,0x02,0x0C,0x02,0x7F,		//   ( 45)  M - 0x4D Latin Capital Letter M
+	0x7F,0x04,0x08,0x10,0x7F,		//   ( 46)  N - 0x4E Latin Capital Letter N
+	0x3E,0x41,0x41,0x41,0x3E,		//   ( 47)  O - 0x4F Latin Capital Letter O
+	0x7F,0x09,0x09,0x09,0x06,		//   ( 48)  P - 0x50 Latin Capital Letter P
+	0x3E,0x41,0x51,0x21,0x5E,		//   ( 49)  Q - 0x51 Latin Capital Letter Q
+	0x7F,0x09,0x19,0x29,0x46,		//   ( 50)  R - 0x52 Latin Capital Letter R
+	0x46,0x49,0x49,0x49,0x31,		//   ( 51)  S - 0x53 Latin Capital Letter S
+	0x01,0x01,0x7F,0x01,0x01,		//   ( 52)  T - 0x54 Latin Capital Letter T
+	0x3F,0x40,0x40,0x40,0x3F,		//   ( 53)  U - 0x55 Latin Capital Letter U
+	0x1F,0x20,0x40,0x20,0x1F,		//   ( 54)  V - 0x56 Latin Capital Letter V
+	0x3F,0x40,0x38,0x40,0x3F,		//   ( 55)  W - 0x57 Latin Capital Letter W
+	0x63,0x14,0x08,0x14,0x63,		//   ( 56)  X - 0x58 Latin Capital Letter X
+	0x07,0x08,0x70,0x08,0x07,		//   ( 57)  Y - 0x59 Latin Capital Letter Y
+	0x61,0x51,0x49,0x45,0x43,		//   ( 58)  Z - 0x5A Latin Capital Letter Z
+	0x7F,0x41,0x41,					//   ( 59)  [ - 0x5B Left Square Bracket
+	0x02,0x04,0x08,0x10,0x20,		//   ( 58)  \ - 0x5C Reverse Solidus
+	0x41,0x41,0x7F,					//   ( 61)  ] - 0x5D Right Square Bracket
+	0x04,0x02,0x01,0x02,0x04,		//   ( 62)  ^ - 0x5E Circumflex Accent
+	0x40,0x40,0x40,0x40,0x40,		//   ( 63)  _ - 0x5F Low Line
+	0x01,0x02,0x04,					//   ( 64)  ` - 0x60 Grave Accent
+	0x20,0x54,0x54,0x54,0x78,		//   ( 65)  a - 0x61 Latin Small Letter A
+	0x7F,0x48,0x44,0x44,0x38,		//   ( 66)  b - 0x62 Latin Small Letter B
+	0x38,0x44,0x44,0x44,0x20,		//   ( 67)  c - 0x63 Latin Small Letter C
+	0x38,0x44,0x44,0x48,0x7F,		//   ( 68)  d - 0x64 Latin Small Letter D
+	0x38,0x54,0x54,0x54,0x18,		//   ( 69)  e - 0x65 Latin Small Letter E
+	0x08,0x7E,0x09,0x01,0x02,		//   ( 70)  f - 0x66 Latin Small Letter F
+	0x08,0x54,0x54,0x54,0x3C,		//   ( 71)  g - 0x67 Latin Small Letter G
+	0x7F,0x08,0x04,0x04,0x78,		//   ( 72)  h - 0x68 Latin Small Letter H
+	0x44,0x7D,0x40,					//   ( 73)  i - 0x69 Latin Small Letter I
+	0x20,0x40,0x44,0x3D,			//   ( 74)  j - 0x6A Latin Small Letter J
+	0x7F,0x10,0x28,0x44,			//   ( 75)  k - 0x6B Latin Small Letter K
+	0x41,0x7F,0x40,					//   ( 76)  l - 0x6C Latin Small Letter L
+	0x7C,0x04,0x18,0x04,0x7C,		//   ( 77)  m - 0x6D Latin Small Letter M
+	0x7C,0x08,0x04,0x04,0x78,		//   ( 78)  n - 0x6E Latin Small Letter N
+	0x38,0x44,0x44,0x44,0x38,		//   ( 79)  o - 0x6F Latin Small Letter O
+	0x7C,0x14,0x14,0x14,0x08,		//   ( 80)  p - 0x70 Latin Small Letter P
+	0x08,0x14,0x14,0x18,0x7C,		//   ( 81)  q - 0x71 Latin Small Letter Q
+	0x7C,0x08,0x04,0x04,0x08,		//   ( 82)  r - 0x72 Latin Small Letter R
+	0x48,0x54,0x54,0x54,0x20,		//   ( 83)  s - 0x73 Latin Small Letter S
+	0x04,0x3F,0x44,0x40,0x20,		//   ( 84)  t - 0x74 Latin Small Letter T
+	0x3C,0x40,0x40,0x20,0x7C,		//   ( 85)  u - 0x75 Latin Small Letter U
+	0x1C,0x20,0x40,0x20,0x1C,		//   ( 86)  v - 0x76 Latin Small Letter V
+	0x3C,0x40,0x30,0x40,0x3C,		//   ( 87)  w - 0x77 Latin Small Letter W
+	0x44,0x28,0x10,0x28,0x44,		//   ( 88)  x - 0x78 Latin Small Letter X
+	0x0C,0x50,0x50,0x50,0x3C,		//   ( 89)  y - 0x79 Latin Small Letter Y
+	0x44,0x64,0x54,0x4C,0x44,		//   ( 90)  z - 0x7A Latin Small Letter Z
+	0x08,0x36,0x41,					//   ( 91)  { - 0x7B Left Curly Bracket
+	0x7F,							//   ( 92)  | - 0x7C Vertical Line
+	0x41,0x36,0x08,					//   ( 93)  } - 0x7D Right Curly Bracket
+	0x02,0x01,0x02,0x04,0x02,		//   ( 94)  ~ - 0x7E Tilde
+	0x00,0x00,						//   ( 95)    - 0xA0 No-Break Space
+	0x79,							//   ( 96)  ! - 0xA1 Inverted Exclamation Mark
+	0x18,0x24,0x74,0x2E,0x24,		//   ( 97)  c - 0xA2 Cent Sign
+	0x48,0x7E,0x49,0x42,0x40,		//   ( 98)  L - 0xA3 Pound Sign
+	0x5D,0x22,0x22,0x22,0x5D,		//   ( 99)  o - 0xA4 Currency Sign
+	0x15,0x16,0x7C,0x16,0x15,		//   (100)  Y - 0xA5 Yen Sign
+	0x77,							//   (101)  | - 0xA6 Broken Bar
+	0x0A,0x55,0x55,0x55,0x28,		//   (102)   - 0xA7 Section Sign
+	0x01,0x00,0x01,					//   (103)  " - 0xA8 Diaeresis
+	0x3E,0x41,0x41,0x41,0x22,		//   (104) (C)- 0xA9 Copyright
+	0x0A,0x0D,0x0A,0x04,			//   (105)    - 0xAA Feminine Ordinal Indicator
+	0x08,0x14,0x2A,0x14,0x22,		//   (106) << - 0xAB Left-Pointing Double Angle Quotation Mark
+	0x04,0x04,0x04,0x04,0x1C,		//   (107)    - 0xAC Not Sign
+	0x08,0x08,0x08,					//   (108)  - - 0xAD Soft Hyphen
+	0x7F,0x09,0x19,0x29,0x46,		//   (109) (R)- 0xAE Registered
+	0x01,0x01,0x01,0x01,0x01,		//   (110)    - 0xAF Macron
+	0x02,0x05,0x02,					//   (111)    - 0xB0 Degree Sign
+	0x44,0x44,0x5F,0x44,0x44,		//   (112) +- - 0xB1 Plus-Minus Sign
+	0x1D,0x17,						//	 (113)   - 0xB2 SUPERSCRIPT TWO
+	0x15,0x1F,						//	 (114)   - 0xB3 SUPERSCRIPT THREE
+	0x04,0x02,0x01,					//   (115)  ` - 0xB4 Acute Accent
+	0x7E,0x20,0x20,0x10,0x3E,		//   (116)  u - 0xB5 Micro Sign
+	0x06,0x0F,0x7F,0x00,0x7F,		//   (117)    - 0xB6 Pilcrow Sign
+	0x18,0x18,						//   (118)  . - 0xB7 Middle Dot
+	0x40,0x50,0x20,					//   (119)    - 0xB8 Cedilla
+	0x02,0x0F,						//	 (120)  1 - 0xB9 SUPERSCRIPT ONE
+	0x0A,0x0D,0x0A,					//   (121)    - 0xBA Masculine Ordinal Indicator
+	0x22,0x14,0x2A,0x14,0x08,		//   (122) >> - 0xBB Right-Pointing Double Angle Quotation Mark
+	0x17,0x08,0x34,0x2A,0x7D,		//   (123) /4 - 0xBC Vulgar Fraction One Quarter
+	0x17,0x08,0x04,0x6A,0x59,		//   (124) /2 - 0xBD Vulgar Fraction One Half
+	0x25,0x12,0x08,0x34,0x62,		//	 (125) 3/4- 0xBE Vulgar Fraction Three Quarter
+	0x30,0x48,0x45,0x40,0x20,		//   (126)  ? - 0xBF Inverted Question Mark
+	0x70,0x29,0x26,0x28,0x70,		//   (127) `A - 0xC0 Latin Capital Letter A with Grave
+	0x70,0x28,0x26,0x29,0x70,		//   (128) 'A - 0xC1 Latin Capital Letter A with Acute
+	0x70,0x2A,0x25,0x2A,0x70,		//   (129) ^A - 0xC2 Latin Capital Letter A with Circumflex
+	0x72,0x29,0x26,0x29,0x70,		//   (130) ~A - 0xC3 Latin Capital Letter A with Tilde
+	0x70,0x29,0x24,0x29,0x70,		//   (131) "A - 0xC4 Latin Capital Letter A with Diaeresis
+	0x70,0x2A,0x2D,0x2A,0x70,		//   (132)  A - 0xC5 Latin Capital Letter A with Ring Above
+	0x7E,0x11,0x7F,0x49,0x49,		//   (133) AE - 0xC6 Latin Capital Letter Ae
+	0x0E,0x51,0x51,0x71,0x11,		//   (134)  C - 0xC7 Latin Capital Letter C with Cedilla
+	0x7C,0x55,0x56,0x54,0x44,		//   (135) `E - 0xC8 Latin Capital Letter E with Grave
+	0x7C,0x55,0x56,0x54,0x44,		//   (136) 'E - 0xC9 Latin Capital Letter E with Acute
+	0x7C,0x56,0x55,0x56,0x44,		//   (137) ^E - 0xCA Latin Capital Letter E with Circumflex
+	0x7C,0x55,0x54,0x55,0x44,		//   (138) "E - 0xCB Latin Capital Letter E with Diaeresis
+	0x45,0x7E,0x44,					//   (139) `I - 0xCC Latin Capital Letter I with Grave
+	0x44,0x7E,0x45,					//   (140) 'I - 0xCD Latin Capital Letter I with Acute
+	0x46,0x7D,0x46,					//   (141) ^I - 0xCE Latin Capital Letter I with Circumflex
+	0x45,0x7C,0x45,					//   (142) "I - 0xCF Latin Capital Letter I with Diaeresis
+	0x7F,0x49,0x49,0x41,0x3E,		//   (143)  D - 0xD0 Latin Capital Letter Eth
+	0x7C,0x0A,0x11,0x22,0x7D,		//   (144) ~N - 0xD1 Latin Capital Letter N with Tilde
+	0x38,0x45,0x46,0x44,0x38,		//   (145) `O - 0xD2 Latin Capital Letter O with Grave
+	0x38,0x44,0x46,0x45,0x38,		//   (146) 'O - 0xD3 Latin Capital Letter O with Acute
+	0x38,0x46,0x45,0x46,0x38,		//   (147) ^O - 0xD4 Latin Capital Letter O with Circumflex
+	0x38,0x46,0x45,0x46,0x39,		//   (148) ~O - 0xD5 Latin Capital Letter O with Tilde
+	0x38,0x45,0x44,0x45,0x38,		//   (149) "O - 0xD6 Latin Capital Letter O with Diaeresis
+	0x22,0x14,0x08,0x14,0x22,		//   (150)  x - 0xD7 Multiplcation Sign
+	0x2E,0x51,0x49,0x45,0x3A,		//   (151)  O - 0xD8 Latin Capital Letter O with Stroke
+	0x3C,0x41,0x42,0x40,0x3C,		//   (152) `U - 0xD9 Latin Capital Letter U with Grave
+	0x3C,0x40,0x42,0x41,0x3C,		//   (153) 'U - 0xDA Latin Capital Letter U with Acute
+	0x3C,0x42,0x41,0x42,0x3C,		//   (154) ^U - 0xDB Latin Capital Letter U with Circumflex
+	0x3C,0x41,0x40,0x41,0x3C,		//   (155) "U - 0xDC Latin Capital Letter U with Diaeresis
+	0x0C,0x10,0x62,0x11,0x0C,		//   (156) `Y - 0xDD Latin Capital Letter Y with Acute
+	0x7F,0x12,0x12,0x12,0x0C,		//   (157)  P - 0xDE Latin Capital Letter Thom
+	0x40,0x3E,0x01,0x49,0x36,		//   (158)  B - 0xDF Latin Capital Letter Sharp S
+	0x20,0x55,0x56,0x54,0x78,		//   (159) `a - 0xE0 Latin Small Letter A with Grave
+	0x20,0x54,0x56,0x55,0x78,		//   (160) 'a - 0xE1 Latin Small Letter A with Acute
+	0x20,0x56,0x55,0x56,0x78,		//   (161) ^a - 0xE2 Latin Small Letter A with Circumflex
+	0x20,0x55,0x56,0x55,0x78,		//   (162) ~a - 0xE3 Latin Small Letter A with Tilde
+	0x20,0x55,0x54,0x55,0x78,		//   (163) "a - 0xE4 Latin Small Letter A with Diaeresis
+	0x20,0x56,0x57,0x56,0x78,		//   (164)  a - 0xE5 Latin Small Letter A with Ring Above
+	0x24,0x54,0x78,0x54,0x58,		//   (165) ae - 0xE6 Latin Small Letter Ae
+	0x0C,0x52,0x52,0x72,0x13,		//   (166)  c - 0xE7 Latin Small Letter c with Cedilla
+	0x38,0x55,0x56,0x54,0x18,		//   (167) `e - 0xE8 Latin Small Letter E with Grave
+	0x38,0x54,0x56,0x55,0x18,		//   (168) 'e - 0xE9 Latin Small Letter E with Acute
+	0x38,0x56,0x55,0x56,0x18,		//   (169) ^e - 0xEA Latin Small Letter E with Circumflex
+	0x38,0x55,0x54,0x55,0x18,		//   (170) "e - 0xEB Latin Small Letter E with Diaeresis
+	0x49,0x7A,0x40,					//   (171) `i - 0xEC Latin Small Letter I with Grave
+	0x48,0x7A,0x41,					//   (172) 'i - 0xED Latin Small Letter I with Acute
+	0x4A,0x79,0x42,					//   (173) ^i - 0xEE Latin Small Letter I with Circumflex
+	0x4A,0x78,0x42,					//   (174) "i - 0xEF Latin Small Letter I with Diaeresis
+	0x31,0x4A,0x4E,0x4A,0x30,		//   (175)    - 0xF0 Latin Small Letter Eth
+	0x7A,0x11,0x0A,0x09,0x70,		//   (176) ~n - 0xF1 Latin Small Letter N with Tilde
+	0x30,0x49,0x4A,0x48,0x30,		//   (177) `o - 0xF2 Latin Small Letter O with Grave
+	0x30,0x48,0x4A,0x49,0x30,		//   (178) 'o - 0xF3 Latin Small Letter O with Acute
+	0x30,0x4A,0x49,0x4A,0x30,		//   (179) ^o - 0xF4 Latin Small Letter O with Circumflex
+	0x30,0x4A,0x49,0x4A,0x31,		//   (180) ~o - 0xF5 Latin Small Letter O with Tilde
+	0x30,0x4A,0x48,0x4A,0x30,		//   (181) "o - 0xF6 Latin Small Letter O with Diaeresis
+	0x08,0x08,0x2A,0x08,0x08,		//   (182)  + - 0xF7 Division Sign
+	0x38,0x64,0x54,0x4C,0x38,		//   (183)  o - 0xF8 Latin Small Letter O with Stroke
+	0x38,0x41,0x42,0x20,0x78,		//   (184) `u - 0xF9 Latin Small Letter U with Grave
+	0x38,0x40,0x42,0x21,0x78,		//   (185) 'u - 0xFA Latin Small Letter U with Acute
+	0x38,0x42,0x41,0x22,0x78,		//   (186) ^u - 0xFB Latin Small Letter U with Circumflex
+	0x38,0x42,0x40,0x22,0x78,		//   (187) "u - 0xFC Latin Small Letter U with Diaeresis
+	0x0C,0x50,0x52,0x51,0x3C,		//   (188) 'y - 0xFD Latin Small Letter Y with Acute
+	0x7E,0x14,0x14,0x14,0x08,		//   (189)  p - 0xFE Latin Small Letter Thom
+	0x0C,0x51,0x50,0x51,0x3C 		//   (190) "y - 0xFF Latin Small Letter Y with Diaeresis
+};
 
- CONTROL_PORT_CONF=0x00;
- DATA_PORT_CONF=0x00;
- DATA_PORT=0x00;
- 
- CONTROL_PORT=0x1F; //OLED_RES=1
- Delay1KTCYx(16); //delay_1ms
- CONTROL_PORT=0x17; //OLED_RES=0
- Delay1KTCYx(160); //delay_10ms
- CONTROL_PORT=0x1F; //OLED_RES=1
- Delay1KTCYx(16); //delay_1ms
+static const UINT16 propFontIndex[192] =		// offset of each glyph in propFont, width = next offset - offset
+{
+	0,2,3,6,11,16,21,26,28,31,34,39,44,46,51,53,
+	58,63,66,71,76,81,86,91,96,101,106,108,110,114,119,123,
+	128,133,138,143,148,153,158,163,168,173,176,181,186,191,196,201,
+	206,211,216,221,226,231,236,241,246,251,256,261,264,269,272,277,
+	282,285,290,295,300,305,310,315,320,325,328,332,336,339,344,349,
+	354,359,364,369,374,379,384,389,394,399,404,409,412,413,416,421,
+	423,424,429,434,439,444,445,450,453,458,462,467,472,475,480,485,
+	488,493,495,497,500,505,510,512,515,517,520,525,530,535,540,545,
+	550,555,560,565,570,575,580,585,590,595,600,605,608,611,614,617,
+	622,627,632,637,642,647,652,657,662,667,672,677,682,687,692,697,
+	702,707,712,717,722,727,732,737,742,747,752,757,760,763,766,769,
+	774,779,784,789,794,799,804,809,814,819,824,829,834,839,844,849
+};
 
-}
 
 /**
-  * @brief  writes a command byte to the display
-  *
-  * @param	data	the command byte
+  * @brief  configures the bus interface and performs a full reset cycle
   */
-static void writeCmd(UINT8 Command2Write)
-{
-	 DATA_PORT=Command2Write;
- CONTROL_PORT=0x1F; //OLED_DC=1
- CONTROL_PORT=0x1B; //OLED_DC=0
- CONTROL_PORT=0x0B; //OLED_CS=0
- CONTROL_PORT=0x09; //OLED_WR=0
- Nop();
- CONTROL_PORT=0x0B; //OLED_WR=1
- CONTROL_PORT=0x0F; //OLED_DC=1
- CONTROL_PORT=0x1F; //OLED_CS=1
-}
+#if SSD1309_PANELS > 1
+static ssd1309_panel_t panel0;				// cs 0 with the built-in framebuffer, the target until a panel is selected
+static ssd1309_panel_t *selected = &panel0;	// the panel the driver state belongs to, see ssd1309_panel_select()
+#endif
 
-/**
-  * @brief  writes graphic data to the display
-  *
-  * @param	data	the data byte to write
-  */
-static void writeData(UINT8 Data2Write)
+static void initInterface(void)
 {
- DATA_PORT= Data2Write;
- CONTROL_PORT=0x1B; //OLED_DC=0
- CONTROL_PORT=0x1F; //OLED_DC=1
- CONTROL_PORT=0x0F; //OLED_CS=0
- CONTROL_PORT=0x0D; //OLED_WR=0
- Nop();
- CONTROL_PORT=0x0F; //OLED_WR=1
- CONTROL_PORT=0x0B; //OLED_DC=0
- CONTROL_PORT=0x1B; //OLED_CS=1
+	ssd1309_bus_init();					// OLED_RES=1
+#if SSD1309_PANELS > 1
+	if (selected->cs != 0)				// RES# is shared, only the first panel pulses it
+	{
+		return;
+	}
+#endif
+	Delay1KTCYx(16);					// delay_1ms
+	ssd1309_bus_reset(true);			// OLED_RES=0
+	Delay1KTCYx(160);					// delay_10ms
+	ssd1309_bus_reset(false);			// OLED_RES=1
+	Delay1KTCYx(16);					// delay_1ms
 }
 
-/**
-  * @brief  controls the reset line of the display
-  *
-  * @param	resetRelease true  = perform a full reset cycle
-  *				         false = make sure that the display is released from reset
-  */
+// writeCmd(), writeData() and the burst writes are provided by the bus backend, see SSD1309_bus.h
+#define writeCmd(command)			ssd1309_bus_writeCmd(command)
+#define writeData(data)				ssd1309_bus_writeData(data)
+#define writeCmdBurst(commands, len)	ssd1309_bus_writeCmdBurst(commands, len)
+#define writeDataBurst(data, len)	ssd1309_bus_writeDataBurst(data, len)
+#define writeDataFill(value, len)	ssd1309_bus_writeDataFill(value, len)
 
 
 
@@ -324,6 +508,11 @@ static void writeData(UINT8 Data2Write)
 ############### command functions, not for user interaction ###################
 #############################################################################*/
 
+static UINT8 addrMode = 2;			// addressing mode the display is in, see cmd_AddressingMode()
+static bool scrollActive = false;	// continuous scrolling is running, see scrollOff()
+static UINT8 scrollStartPage;		// pages moved by the scrolling
+static UINT8 scrollEndPage;
+
 /**
   * @brief  Set the memory addressing mode
   *
@@ -335,10 +524,16 @@ static void writeData(UINT8 Data2Write)
   */
 static void cmd_AddressingMode(UINT8 mode)
 {
-	writeCmd(0x20);			// Set Memory Addressing Mode
-	writeCmd(mode);			//   Default => 2
+	UINT8 cmd[2];
+
+	cmd[0] = 0x20;			// Set Memory Addressing Mode
+	cmd[1] = mode;			//   Default => 2
+	writeCmdBurst(cmd, sizeof(cmd));
+	addrMode = mode;
 }
 
+#ifndef SSD1309_BUFFERED
+
 /**
   * @brief  Set column start Address for Page Addressing Mode
   *
@@ -349,13 +544,13 @@ static void cmd_AddressingMode(UINT8 mode)
   *
   * @param	address The start address (0-255?)
   */
-static void cmd_ColumnStartAddress(UINT8 address)
-{
-	writeCmd(0x00+address%16);		// Set Lower Column Start Address for Page Addressing Mode
+//static void cmd_ColumnStartAddress(UINT8 address)
+//{
+	//writeCmd(0x00+address%16);		// Set Lower Column Start Address for Page Addressing Mode
 	//   Default => 0x00
-	writeCmd(0x10+address/16);		// Set Higher Column Start Address for Page Addressing Mode
+	//writeCmd(0x10+address/16);		// Set Higher Column Start Address for Page Addressing Mode
 	//   Default => 0x10
-}
+//}
 
 /**
   * @brief  Set Page Start Address for Page Addressing Mode
@@ -366,11 +561,34 @@ static void cmd_ColumnStartAddress(UINT8 address)
   *
   * @param	page The start page (0-7)
   */
-static void cmd_PageStartAddress(UINT8 page)
+//static void cmd_PageStartAddress(UINT8 page)
+//{
+	//writeCmd(0xB0|page);			// Set Page Start Address for Page Addressing Mode
+//}
+
+/**
+  * @brief  Set page and column start address for Page Addressing Mode
+  *
+  *         The three commands of cmd_PageStartAddress() and cmd_ColumnStartAddress()
+  *         in one command list.
+  *
+  * @note   This command is only for page addressing mode.
+  *
+  * @param	page	The start page (0-7)
+  * @param  address	The column start address (0-127)
+  */
+static void cmd_PageColumnStart(UINT8 page, UINT8 address)
 {
-	writeCmd(0xB0|page);			// Set Page Start Address for Page Addressing Mode
+	UINT8 cmd[3];
+
+	cmd[0] = 0xB0|page;				// Set Page Start Address for Page Addressing Mode
+	cmd[1] = 0x00+address%16;		// Set Lower Column Start Address for Page Addressing Mode
+	cmd[2] = 0x10+address/16;		// Set Higher Column Start Address for Page Addressing Mode
+	writeCmdBurst(cmd, sizeof(cmd));
 }
 
+#endif
+
 /**
   * @brief  Setup column start and end address.
   *
@@ -379,12 +597,15 @@ static void cmd_PageStartAddress(UINT8 page)
   * @param	start Column start address (0-127)
   * @para,  end	  Column end address (0-127)
   */
-//static void cmd_ColumnAddress(UINT8 start, UINT8 end)
-//{
-	//writeCmd(0x21);			// Set Column Address
-	//writeCmd(start);			//   Default => 0 (Column Start Address)
-	//writeCmd(end);				//   Default => 131 (Column End Address)
-//}
+static void cmd_ColumnAddress(UINT8 start, UINT8 end)
+{
+	UINT8 cmd[3];
+
+	cmd[0] = 0x21;			// Set Column Address
+	cmd[1] = start;			//   Default => 0 (Column Start Address)
+	cmd[2] = end;			//   Default => 127 (Column End Address)
+	writeCmdBurst(cmd, sizeof(cmd));
+}
 
 /**
   * @brief  Setup page start and end address.
@@ -394,12 +615,17 @@ static void cmd_PageStartAddress(UINT8 page)
   * @param	start Page start Address (0-7)
   * @para,  end	  Page end Address (0-7)
   */
-//static void cmd_PageAddress(UINT8 start, UINT8 end)
-//{
-	//writeCmd(0x22);			// Set Page Address
-	//writeCmd(start);			//   Default => 0 (Page Start Address)
-	//writeCmd(end);				//   Default => 7 (Page End Address)
-//}
+static void cmd_PageAddress(UINT8 start, UINT8 end)
+{
+	UINT8 cmd[3];
+
+	cmd[0] = 0x22;			// Set Page Address
+	cmd[1] = start;			//   Default => 0 (Page Start Address)
+	cmd[2] = end;			//   Default => 7 (Page End Address)
+	writeCmdBurst(cmd, sizeof(cmd));
+}
+
+#ifndef SSD1309_STRIP				// only the console moves the start line
 
 /**
   * @brief  Set display RAM display start line register.
@@ -412,6 +638,8 @@ static void cmd_StartLine(UINT8 line)
 	//   Default => 64 (0x00)
 }
 
+#endif
+
 /**
   * @brief  set display contrast
   *
@@ -419,10 +647,13 @@ static void cmd_StartLine(UINT8 line)
   *
   * @param	contrast contrast value 0-255
   */
-static void cmd_ContrastControl(UINT8 contrast)
+void cmd_ContrastControl(UINT8 contrast)
 {
-	writeCmd(0x81);			// Set Contrast Control for Bank 0
-	writeCmd(contrast);		// 
+	UINT8 cmd[2];
+
+	cmd[0] = 0x81;			// Set Contrast Control for Bank 0
+	cmd[1] = contrast;
+	writeCmdBurst(cmd, sizeof(cmd));
 }
 
 /**
@@ -431,17 +662,17 @@ static void cmd_ContrastControl(UINT8 contrast)
   * @param	remap false: Column Address 0 Mapped to SEG0
   *               true:  Column Address 0 Mapped to SEG131
   */
-static void cmd_SegmentRemap(bool remap)
-{
-	if (remap)
-	{
-		writeCmd(0xA1);	// 0xA1 => Column Address 0 Mapped to SEG131
-	} 
-	else
-	{
-		writeCmd(0xA0);	// 0xA0 => Column Address 0 Mapped to SEG0
-	}
-}
+//static void cmd_SegmentRemap(bool remap)
+//{
+	//if (remap)
+	//{
+		//writeCmd(0xA1);	// 0xA1 => Column Address 0 Mapped to SEG131
+	//} 
+	//else
+	//{
+		//writeCmd(0xA0);	// 0xA0 => Column Address 0 Mapped to SEG0
+	//}
+//}
 
 /**
   * @brief  Set COM Output Scan Direction
@@ -449,17 +680,17 @@ static void cmd_SegmentRemap(bool remap)
   * @param	remap false: Scan from COM0 to 63
   *               true:  Scan from COM63 to 0
   */
-static void cmd_ComRemap(bool remap)
-{
-	if (remap)
-	{
-		writeCmd(0xC8);	// 0xC8 (0x08) => Scan from COM63 to 0
-	}
-	else
-	{
-		writeCmd(0xC0);	// 0xC0 (0x00) => Scan from COM0 to 63
-	}
-}
+//static void cmd_ComRemap(bool remap)
+//{
+	//if (remap)
+	//{
+		//writeCmd(0xC8);	// 0xC8 (0x08) => Scan from COM63 to 0
+	//}
+	//else
+	//{
+		//writeCmd(0xC0);	// 0xC0 (0x00) => Scan from COM0 to 63
+	//}
+//}
 
 /**
   * @brief  Display Test
@@ -468,45 +699,45 @@ static void cmd_ComRemap(bool remap)
   *
   * @param	on  all pixel on if true, normal operation if false
   */
-static void cmd_EntireDisplayON(bool on)
-{
-	if (on)
-	{
-		writeCmd(0xA5);	//     0xA5 => Entire Display On
-	} 
-	else
-	{
-		writeCmd(0xA4);	//     0xA4 => Normal Display
-	}
-}
+//static void cmd_EntireDisplayON(bool on)
+//{
+	//if (on)
+	//{
+		//writeCmd(0xA5);	//     0xA5 => Entire Display On
+	//} 
+	//else
+	//{
+		//writeCmd(0xA4);	//     0xA4 => Normal Display
+	//}
+//}
 
 /**
   * @brief  Normal/Inverse Display
   *
   * @param	inverse Inverse display content if true
   */
-static void cmd_InverseDisplay(bool inverse)
-{
-	if (inverse)
-	{
-		writeCmd(0xA7);	//     0xA7 => Inverse Display On
-	}
-	else
-	{
-		writeCmd(0xA6);	//     0xA6 => Normal Display
-	}
-}
+//static void cmd_InverseDisplay(bool inverse)
+//{
+	//if (inverse)
+	//{
+		//writeCmd(0xA7);	//     0xA7 => Inverse Display On
+	//}
+	//else
+	//{
+		//writeCmd(0xA6);	//     0xA6 => Normal Display
+	//}
+//}
 
 /**
   * @brief  Set Multiplex Ratio
   *
   * @param	mux	Multiplex Ratio (16-64)
   */
-static void cmd_MultiplexRatio(UINT8 mux)
-{
-	writeCmd(0xA8);			// Set Multiplex Ratio
-	writeCmd(mux-1);			//   Default => 64 (1/64 Duty)
-}
+//static void cmd_MultiplexRatio(UINT8 mux)
+//{
+	//writeCmd(0xA8);			// Set Multiplex Ratio
+	//writeCmd(mux-1);			//   Default => 64 (1/64 Duty)
+//}
 
 /**
   * @brief  Turn Display on
@@ -532,37 +763,37 @@ static void cmd_DisplayOn(bool on)
   *
   * @param	offset  Set vertical shift by COM (0-63)
   */
-static void cmd_DisplayOffset(UINT8 offset)
-{
-	writeCmd(0xD3);			// Set Display Offset
-	writeCmd(offset);		//   Default => 0
-}
+//static void cmd_DisplayOffset(UINT8 offset)
+//{
+	//writeCmd(0xD3);			// Set Display Offset
+	//writeCmd(offset);		//   Default => 0
+//}
 
 /**
   * @brief  Set Display Clock Divide Ratio/Oscillator Frequency
   *
   * @param	value see SSD1309 datasheet page 34
   */
-static void cmd_DisplayClock(UINT8 value)
-{
-	writeCmd(0xD5);			// Set Display Clock Divide Ratio / Oscillator Frequency
-	writeCmd(value);		// Default => 0x70
-	//     D[3:0] => Display Clock Divider
-	//     D[7:4] => Oscillator Frequency
-}
+//static void cmd_DisplayClock(UINT8 value)
+//{
+	//writeCmd(0xD5);			// Set Display Clock Divide Ratio / Oscillator Frequency
+	//writeCmd(value);		// Default => 0x70
+	////     D[3:0] => Display Clock Divider
+	////     D[7:4] => Oscillator Frequency
+//}
 
 /**
   * @brief  Set Pre-charge Period
   *
   * @param	value see SSD1309 datasheet page 34
   */
-static void cmd_PrechargePeriod(UINT8 value)
-{
-	writeCmd(0xD9);			// Set Pre-Charge Period
-	writeCmd(value);		//   Default => 0x22 (2 Display Clocks [Phase 2] / 2 Display Clocks [Phase 1])
-	//     D[3:0] => Phase 1 Period in 1~15 Display Clocks
-	//     D[7:4] => Phase 2 Period in 1~15 Display Clocks
-}
+//static void cmd_PrechargePeriod(UINT8 value)
+//{
+	//writeCmd(0xD9);			// Set Pre-Charge Period
+	//writeCmd(value);		//   Default => 0x22 (2 Display Clocks [Phase 2] / 2 Display Clocks [Phase 1])
+	////     D[3:0] => Phase 1 Period in 1~15 Display Clocks
+	////     D[7:4] => Phase 2 Period in 1~15 Display Clocks
+//}
 
 /**
   * @brief  Set COM Pins Hardware Configuration
@@ -572,22 +803,22 @@ static void cmd_PrechargePeriod(UINT8 value)
   *                 2: Sequential COM pin configuration, Enable COM Left/Right remap
   *                 3: Alternative COM pin configuration, Enable COM Left/Right remap
   */
-static void cmd_ComPins(UINT8 config)
-{
-	writeCmd(0xDA);				// Set COM Pins Hardware Configuration
-	writeCmd((config<<4)|0x02);	// Default => 0x12
-}
+//static void cmd_ComPins(UINT8 config)
+//{
+	//writeCmd(0xDA);				// Set COM Pins Hardware Configuration
+	//writeCmd((config<<4)|0x02);	// Default => 0x12
+//}
 
 /**
   * @brief  Set VCOMH deselect Level
   *
   * @param	value see SSD1309 datasheet page 34
   */
-static void cmd_Vcomh(UINT8 value)
-{
-	writeCmd(0xDB);			// Set VCOMH deselect Level
-	writeCmd(value);		// Default => 52 (0.78*VCC)
-}
+//static void cmd_Vcomh(UINT8 value)
+//{
+	//writeCmd(0xDB);			// Set VCOMH deselect Level
+	//writeCmd(value);		// Default => 52 (0.78*VCC)
+//}
 
 /**
   * @brief  No operation command
@@ -599,181 +830,1851 @@ static void cmd_Vcomh(UINT8 value)
 
 
 /*#############################################################################
-################# high level functions for user interaction ###################
+############# output functions, write to framebuffer or display ###############
 #############################################################################*/
 
-void ssd1309_clear(void)
-{
-	unsigned char i,j;
-
-	for(i=0;i<(SSD1309_ROW/8);i++)
-	{
-		cmd_PageStartAddress(i);
-		cmd_ColumnStartAddress(0);
+#ifdef SSD1309_FRAMEBUFFER
 
-		for(j=0;j<SSD1309_COL;j++)
-		{
-			writeData(0x00);
-		}
-	}
-}
+#if SSD1309_PANELS > 1
+static UINT8 fbMemory[SSD1309_PAGES][SSD1309_COL];		// built-in buffer, see ssd1309_panel_init()
+static UINT8 (*framebuffer)[SSD1309_COL] = fbMemory;	// buffer of the selected panel
+#else
+static UINT8 framebuffer[SSD1309_PAGES][SSD1309_COL];	// page-major, same layout as the GDDRAM
+#endif
+STATIC_ASSERT(SSD1309_BUFFER_SIZE <= 0xFFFF, framebuffer_size);	// byte counts are UINT16
+static UINT8 fbPage;									// write position of putData()
+static UINT8 fbCol;
+static UINT8 dirtyMin[SSD1309_PAGES];					// first changed column per page, SSD1309_COL = clean
+static UINT8 dirtyMax[SSD1309_PAGES];					// last changed column per page
+static UINT8 flushMin[SSD1309_PAGES];					// spans the running flush still has to send
+static UINT8 flushMax[SSD1309_PAGES];
+static UINT8 flushPage = SSD1309_PAGES;					// page the flush is sending, SSD1309_PAGES = frame complete
+static UINT8 flushCol;									// next column of flushPage to send
+static UINT8 flushLast;									// last page of the open window
+static bool flushOpen;									// the display address pointer is at flushPage/flushCol
 
-void ssd1309_putc(unsigned char aChar, UINT8 page, UINT8 startColumn)
+/**
+  * @brief  extends the dirty column span of a page
+  *
+  * @param	page		the page (0-7)
+  * @param  startCol	first changed column
+  * @param  endCol		last changed column, >= startCol
+  */
+static void setDirty(UINT8 page, UINT8 startCol, UINT8 endCol)
 {
-	UINT8 i;
-	
-	if((aChar >= 0x20) && (aChar <= 0x7E))	// normal ASCII Char
+	if (startCol < dirtyMin[page])
 	{
-		aChar -= 0x20;						// subtract to match index
+		dirtyMin[page] = startCol;
 	}
-	else if (aChar >= 0xA0)					// extended UTF8 char
+	if (endCol > dirtyMax[page])
 	{
-		aChar -= 0x41;						// subtract to match index
+		dirtyMax[page] = endCol;
 	}
-	else									// char not available
-	{
-		aChar = '?' - 0x20;					// make a ?
-	}	
-	
-	cmd_PageStartAddress(page);
-	cmd_ColumnStartAddress(startColumn);
+}
 
-	for(i=0;i<5;i++)
-	{
-		writeData(pgm_read_byte(&font[aChar][i]));
-	}
-	writeData(0);
+/**
+  * @brief  marks all pages as clean
+  */
+static void setClean(void)
+{
+	memset(dirtyMin, SSD1309_COL, sizeof(dirtyMin));
+	memset(dirtyMax, 0, sizeof(dirtyMax));
 }
 
-void ssd1309_putBigDigit(unsigned char aDigit, UINT8 page, UINT8 startColumn)
+#endif
+
+#ifdef SSD1309_STRIP
+
+static UINT8 strip[SSD1309_STRIP_PAGES][SSD1309_COL];	// the pages of the strip that is rendered
+static UINT8 stripPage;									// first page of the strip
+static UINT8 fbPage;									// write position of putData()
+static UINT8 fbCol;
+
+/**
+  * @brief  returns true if the page is part of the strip that is rendered
+  */
+static bool inStrip(UINT8 page)
 {
-	UINT8 i;	
-	
-	if((aDigit >= '+') && (aDigit <= '9'))			// Digit is printable
-	{
-		cmd_PageStartAddress(page);
-		cmd_ColumnStartAddress(startColumn);		
-		
-		for(i=0;i<13;i++)
-		{
-			writeData(pgm_read_byte(&bigDigit[(aDigit-'+')][i]));
-		}
-		
-		writeData(0);
-		writeData(0);
-		
-		cmd_PageStartAddress(page+1);
-		cmd_ColumnStartAddress(startColumn);
-		
-		for(i=0;i<13;i++)
-		{
-			writeData(pgm_read_byte(&bigDigit[(aDigit-'+')][i+13]));
-		}
-		
-		writeData(0);
-		writeData(0);		
-	}
-	else								// make a whitespace
-	{
-		cmd_PageStartAddress(page);
-		cmd_ColumnStartAddress(startColumn);		
-		
-		for(i=0;i<15;i++)
-		{
-			writeData(0);
-		}
-		
-		cmd_PageStartAddress(page+1);
-		cmd_ColumnStartAddress(startColumn);
-		
-		for(i=0;i<15;i++)
-		{
-			writeData(0);
-		}
-	}		
+	return ((UINT8)(page - stripPage) < SSD1309_STRIP_PAGES);
 }
 
+#endif
 
-void ssd1309_print(char *aString, UINT8 page, UINT8 startColumn)
+/**
+  * @brief  stops a continuous scrolling, the GDDRAM must not be written while it runs
+  *
+  *			The scrolling has moved the GDDRAM content of the scrolled pages. With the
+  *			framebuffer these pages become dirty, so the next flush restores them.
+  */
+static void scrollOff(void)
 {
-	char * Src_Pointer = aString;			// copy the pointer, because will will increment it
-		
-	while(*Src_Pointer != '\0')				// until string end
+#ifdef SSD1309_FRAMEBUFFER
+	UINT8 page;
+
+	for(page=scrollStartPage;page<=scrollEndPage;page++)
 	{
-		ssd1309_putc((unsigned char)*Src_Pointer, page, startColumn);
-		Src_Pointer++;
-		startColumn+=6;
+		setDirty(page, 0, SSD1309_COL-1);
 	}
+#endif
+	writeCmd(0x2E);					// Deactivate Scroll
+	scrollActive = false;
 }
 
-void ssd1309_print_bigDigit(char *aString, UINT8 page, UINT8 startColumn)
+/**
+  * @brief  sets the position for the following putData() calls
+  *
+  *			Behaves like the page addressing mode of the display: the column is
+  *			incremented after each byte and wraps inside the page.
+  *
+  * @param	page	the page (0-7)
+  * @param  column	the column (0-127)
+  */
+static void gotoPos(UINT8 page, UINT8 column)
 {
-	char * Src_Pointer = aString;			// copy the pointer, because will will increment it
-		
-	while(*Src_Pointer != '\0')				// until string end
+#ifdef SSD1309_BUFFERED
+	fbPage = page;
+	fbCol = column;
+#else
+	if (scrollActive)
 	{
-		ssd1309_putBigDigit((unsigned char)*Src_Pointer, page, startColumn);
-		Src_Pointer++;
-		startColumn+=15;
+		scrollOff();
+	}
+	if (addrMode != 2)
+	{
+		cmd_AddressingMode(2);		// Page Addressing Mode
 	}
+	cmd_PageColumnStart(page, column);
+#endif
 }
 
-void ssd1309_print_P(const char* aString, UINT8 page, UINT8 startColumn)
+/**
+  * @brief  opens a horizontal addressing mode window on the display
+  *
+  *			The following data bytes fill the window column by column and page by page,
+  *			so a rectangular area is written with one single stream.
+  *
+  * @param	startCol	first column of the window
+  * @param  endCol		last column of the window
+  * @param  startPage	first page of the window
+  * @param  endPage		last page of the window
+  */
+static void setWindow(UINT8 startCol, UINT8 endCol, UINT8 startPage, UINT8 endPage)
 {
-	UINT8 tmp;
-	const char* Src_Pointer = aString;			// copy the pointer, because will will increment it	
-	
-	tmp = pgm_read_byte(Src_Pointer);
-	while(tmp != '\0')
+	if (scrollActive)
 	{
-		ssd1309_putc(tmp, page, startColumn);
-		Src_Pointer++;
-		tmp = pgm_read_byte(Src_Pointer);
-		startColumn+=6;
+		scrollOff();
+	}
+	if (addrMode != 0)
+	{
+		cmd_AddressingMode(0);		// Horizontal Addressing Mode
 	}
+	cmd_ColumnAddress(startCol, endCol);
+	cmd_PageAddress(startPage, endPage);
 }
 
-void ssd1309_printf(UINT8 page, UINT8 startColumn, const char* __fmt, ...)
+/**
+  * @brief  writes one graphic byte at the current position
+  *
+  * @param	data	the data byte
+  */
+static void putData(UINT8 data)
 {
-	char aString[64];
-	va_list argumentlist;
-	va_start(argumentlist, __fmt);
-	sprintf(aString, __fmt, argumentlist);
-	va_end(argumentlist);
-	ssd1309_print(aString, page, startColumn);
+#ifdef SSD1309_FRAMEBUFFER
+	if ((fbPage < SSD1309_PAGES) && (fbCol < SSD1309_COL) && (framebuffer[fbPage][fbCol] != data))
+	{
+		framebuffer[fbPage][fbCol] = data;
+		setDirty(fbPage, fbCol, fbCol);
+	}
+	if (++fbCol >= SSD1309_COL)
+	{
+		fbCol = 0;
+	}
+#elif defined(SSD1309_STRIP)
+	if (inStrip(fbPage) && (fbCol < SSD1309_COL))
+	{
+		strip[fbPage-stripPage][fbCol] = data;
+	}
+	if (++fbCol >= SSD1309_COL)
+	{
+		fbCol = 0;
+	}
+#else
+	writeData(data);
+#endif
 }
 
-void ssd1309_printf_P(UINT8 page, UINT8 startColumn, const char* __fmt, ...)
+/**
+  * @brief  writes a run of graphic bytes at the current position
+  *
+  * @param	*data	pointer to the data bytes, may point to program memory
+  * @param  len		number of bytes
+  */
+static void putDataBurst(const UINT8 *data, UINT8 len)
 {
-	char aString[64];	
-	va_list argumentlist;
-	va_start(argumentlist, __fmt);
-	vsprintf(aString, __fmt, argumentlist);
-	va_end(argumentlist);
-	ssd1309_print(aString, page, startColumn);
+#ifdef SSD1309_BUFFERED
+#ifdef SSD1309_STRIP
+	if (!inStrip(fbPage))			// outside the strip, only the position moves on
+	{
+		fbCol = (fbCol + len) % SSD1309_COL;
+		return;
+	}
+#endif
+	while (len--)
+	{
+		putData(pgm_read_byte(data++));
+	}
+#else
+	writeDataBurst(data, len);
+#endif
 }
 
-void ssd1309_showPic(const UINT8 *pic, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol)
+/**
+  * @brief  writes the same graphic byte several times at the current position
+  *
+  * @param	value	the data byte
+  * @param  len		number of bytes
+  */
+static void putDataFill(UINT8 value, UINT8 len)
 {
-	UINT8 i,j;
-	
-	for(i=startPage;i<=endPage;i++)
+#ifdef SSD1309_BUFFERED
+#ifdef SSD1309_STRIP
+	if (!inStrip(fbPage))			// outside the strip, only the position moves on
 	{
-		cmd_PageStartAddress(i);
-		cmd_ColumnStartAddress(startCol);
-
-		for(j=0;j<totalCol;j++)
-		{
-			writeData(pgm_read_byte(pic+i*totalCol+j));
-		}
+		fbCol = (fbCol + len) % SSD1309_COL;
+		return;
+	}
+#endif
+	while (len--)
+	{
+		putData(value);
 	}
+#else
+	writeDataFill(value, len);
+#endif
 }
 
-void ssd1309_drawBargraph(UINT8 percent, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol)
-{
-	UINT8 i, j, bar, dummy;
-	
-	UINT8 height = ((endPage-startPage)*8+8);
+#ifdef SSD1309_FRAMEBUFFER
+
+/**
+  * @brief  sets or clears the masked bits of a run of framebuffer bytes
+  *
+  * @param	page	the page (0-7)
+  * @param  column	first column
+  * @param  len		number of bytes, the run must not leave the page
+  * @param  mask	bits to change in each byte
+  * @param  color	SSD1309_WHITE sets, SSD1309_BLACK clears the masked bits
+  */
+static void fbModify(UINT8 page, UINT8 column, UINT8 len, UINT8 mask, UINT8 color)
+{
+	UINT8 *ptr = &framebuffer[page][column];
+	UINT8 first = SSD1309_COL, last = 0;
+	UINT8 value;
+
+	for(;len;len--,column++,ptr++)
+	{
+		value = color ? (*ptr | mask) : (*ptr & ~mask);
+		if (value != *ptr)
+		{
+			*ptr = value;
+			if (first == SSD1309_COL)
+			{
+				first = column;
+			}
+			last = column;
+		}
+	}
+	if (first != SSD1309_COL)
+	{
+		setDirty(page, first, last);
+	}
+}
+
+#elif defined(SSD1309_STRIP)
+
+/**
+  * @brief  sets or clears the masked bits of a run of strip bytes, pages outside the strip are skipped
+  *
+  * @param	page	the page (0-7)
+  * @param  column	first column
+  * @param  len		number of bytes, the run must not leave the page
+  * @param  mask	bits to change in each byte
+  * @param  color	SSD1309_WHITE sets, SSD1309_BLACK clears the masked bits
+  */
+static void fbModify(UINT8 page, UINT8 column, UINT8 len, UINT8 mask, UINT8 color)
+{
+	UINT8 *ptr;
+
+	if (!inStrip(page))
+	{
+		return;
+	}
+	ptr = &strip[page-stripPage][column];
+	for(;len;len--,ptr++)
+	{
+		*ptr = color ? (*ptr | mask) : (*ptr & ~mask);
+	}
+}
+
+#endif
+
+
+/*#############################################################################
+################# high level functions for user interaction ###################
+#############################################################################*/
+
+void ssd1309_clear(void)
+{
+#ifdef SSD1309_FRAMEBUFFER
+	UINT8 page, first, last;
+
+	for(page=0;page<SSD1309_PAGES;page++)			// only the span that was set becomes dirty
+	{
+		for(first=0;(first<SSD1309_COL)&&(framebuffer[page][first]==0x00);first++);
+		if (first == SSD1309_COL)
+		{
+			continue;
+		}
+		for(last=SSD1309_COL-1;framebuffer[page][last]==0x00;last--);
+		memset(&framebuffer[page][first], 0x00, last-first+1);
+		setDirty(page, first, last);
+	}
+#elif defined(SSD1309_STRIP)
+	memset(strip, 0x00, sizeof(strip));
+#else
+	ssd1309_clearRect(0, 0, SSD1309_COL, SSD1309_ROW);
+#endif
+}
+
+void ssd1309_fillRect(UINT8 x, UINT8 y, UINT8 w, UINT8 h, UINT8 color)
+{
+	UINT8 firstPage, lastPage, topMask, bottomMask;
+#ifdef SSD1309_BUFFERED
+	UINT8 page;
+#else
+	UINT8 pattern;
+#endif
+
+	if ((x >= SSD1309_COL) || (y >= SSD1309_ROW) || (w == 0) || (h == 0))
+	{
+		return;
+	}
+	if (w > (SSD1309_COL - x))				// clip at the panel edges
+	{
+		w = SSD1309_COL - x;
+	}
+	if (h > (SSD1309_ROW - y))
+	{
+		h = SSD1309_ROW - y;
+	}
+
+	firstPage = y/8;
+	lastPage = (y+h-1)/8;
+	topMask = 0xFF << (y%8);				// rows of the first page inside the rectangle
+	bottomMask = 0xFF >> (7-(y+h-1)%8);		// rows of the last page inside the rectangle
+	if (firstPage == lastPage)
+	{
+		topMask &= bottomMask;
+	}
+
+#ifdef SSD1309_BUFFERED
+	fbModify(firstPage, x, w, topMask, color);
+	for(page=firstPage+1;page<lastPage;page++)
+	{
+		fbModify(page, x, w, 0xFF, color);
+	}
+	if (lastPage != firstPage)
+	{
+		fbModify(lastPage, x, w, bottomMask, color);
+	}
+#else
+	pattern = color ? 0xFF : 0x00;
+	setWindow(x, x+w-1, firstPage, lastPage);
+	writeDataFill(pattern & topMask, w);
+	if (lastPage != firstPage)
+	{
+		writeDataFill(pattern, (UINT16)w * (lastPage-firstPage-1));
+		writeDataFill(pattern & bottomMask, w);
+	}
+#endif
+}
+
+void ssd1309_clearRect(UINT8 x, UINT8 y, UINT8 w, UINT8 h)
+{
+	ssd1309_fillRect(x, y, w, h, SSD1309_BLACK);
+}
+
+#ifdef SSD1309_BUFFERED
+
+#ifdef SSD1309_CANVAS
+static int originX = 0;					// canvas column of the panel drawn by ssd1309_canvas_draw()
+#endif
+
+/**
+  * @brief  sets or clears a horizontal run of pixels, clipped at the panel edges
+  *
+  *			All pixels are in one page, so every column gets the same single bit mask.
+  */
+static void spanH(int x0, int x1, int y, UINT8 color)
+{
+#ifdef SSD1309_CANVAS
+	x0 -= originX;
+	x1 -= originX;
+#endif
+	if ((y < 0) || (y >= SSD1309_ROW) || (x1 < 0) || (x0 >= SSD1309_COL))
+	{
+		return;
+	}
+	if (x0 < 0)
+	{
+		x0 = 0;
+	}
+	if (x1 >= SSD1309_COL)
+	{
+		x1 = SSD1309_COL-1;
+	}
+	if (x0 <= x1)
+	{
+		fbModify(y/8, x0, x1-x0+1, 1 << (y%8), color);
+	}
+}
+
+/**
+  * @brief  sets or clears a vertical run of pixels, clipped at the panel edges
+  *
+  *			One mask per page, the inner pages are set as whole bytes.
+  */
+static void spanV(int x, int y0, int y1, UINT8 color)
+{
+	UINT8 page, lastPage, mask;
+
+#ifdef SSD1309_CANVAS
+	x -= originX;
+#endif
+	if ((x < 0) || (x >= SSD1309_COL) || (y1 < 0) || (y0 >= SSD1309_ROW))
+	{
+		return;
+	}
+	if (y0 < 0)
+	{
+		y0 = 0;
+	}
+	if (y1 >= SSD1309_ROW)
+	{
+		y1 = SSD1309_ROW-1;
+	}
+	if (y0 > y1)
+	{
+		return;
+	}
+	lastPage = y1/8;
+	mask = 0xFF << (y0%8);
+	for(page=y0/8;page<=lastPage;page++)
+	{
+		if (page == lastPage)
+		{
+			mask &= 0xFF >> (7-y1%8);
+		}
+		fbModify(page, x, 1, mask, color);
+		mask = 0xFF;
+	}
+}
+
+/**
+  * @brief  sets or clears one pixel, clipped at the panel edges
+  */
+static void plot(int x, int y, UINT8 color)
+{
+#ifdef SSD1309_CANVAS
+	x -= originX;
+#endif
+	if ((x >= 0) && (x < SSD1309_COL) && (y >= 0) && (y < SSD1309_ROW))
+	{
+		fbModify(y/8, x, 1, 1 << (y%8), color);
+	}
+}
+
+void ssd1309_drawPixel(int x, UINT8 y, UINT8 color)
+{
+	plot(x, y, color);
+}
+
+void ssd1309_drawHLine(int x, UINT8 y, UINT8 w, UINT8 color)
+{
+	if (w)
+	{
+		spanH(x, (int)x+w-1, y, color);
+	}
+}
+
+void ssd1309_drawVLine(int x, UINT8 y, UINT8 h, UINT8 color)
+{
+	if (h)
+	{
+		spanV(x, y, (int)y+h-1, color);
+	}
+}
+
+void ssd1309_drawLine(int x0, UINT8 y0, int x1, UINT8 y1, UINT8 color)
+{
+	int dx, dy, err, step, x, y, run;
+	
+	if (x0 > x1)							// always from left to right
+	{
+		x = x0; x0 = x1; x1 = x;
+		y = y0; y0 = y1; y1 = y;
+	}
+	dx = x1 - x0;
+	dy = (y1 > y0) ? (y1 - y0) : (y0 - y1);
+	step = (y1 > y0) ? 1 : -1;
+	
+	if (dx >= dy)							// flat line: one horizontal span per row
+	{
+		err = dx/2;
+		y = y0;
+		run = x0;
+		for(x=x0;x<=x1;x++)
+		{
+			err -= dy;
+			if (err < 0)
+			{
+				spanH(run, x, y, color);
+				run = x+1;
+				y += step;
+				err += dx;
+			}
+		}
+		spanH(run, x1, y, color);
+	}
+	else									// steep line: one vertical span per column
+	{
+		err = dy/2;
+		x = x0;
+		run = y0;
+		for(y=y0;y!=(int)y1+step;y+=step)
+		{
+			err -= dx;
+			if (err < 0)
+			{
+				spanV(x, (step > 0) ? run : y, (step > 0) ? y : run, color);
+				run = y+step;
+				x++;
+				err += dy;
+			}
+		}
+		if (run != (int)y1+step)
+		{
+			spanV(x, (step > 0) ? run : y1, (step > 0) ? y1 : run, color);
+		}
+	}
+}
+
+void ssd1309_drawRect(int x, UINT8 y, UINT8 w, UINT8 h, UINT8 color)
+{
+	if ((w == 0) || (h == 0))
+	{
+		return;
+	}
+	spanH(x, (int)x+w-1, y, color);
+	spanH(x, (int)x+w-1, (int)y+h-1, color);
+	spanV(x, y, (int)y+h-1, color);
+	spanV((int)x+w-1, y, (int)y+h-1, color);
+}
+
+/**
+  * @brief  draws the quarters of a circle outline selected by corners
+  *
+  * @param	cx, cy		center of the circle
+  * @param  r			radius
+  * @param  corners		bit 0 = top left, 1 = top right, 2 = bottom right, 3 = bottom left
+  * @param  dx, dy		distance the right and the lower quarters are moved away from the center
+  * @param  color		SSD1309_WHITE or SSD1309_BLACK
+  */
+static void drawArcs(int cx, int cy, int r, UINT8 corners, int dx, int dy, UINT8 color)
+{
+	int f = 1 - r;
+	int ddx = 1;
+	int ddy = -2 * r;
+	int x = 0;
+	int y = r;
+	
+	while (x <= y)
+	{
+		if (corners & 0x01)
+		{
+			plot(cx - y, cy - x, color);
+			plot(cx - x, cy - y, color);
+		}
+		if (corners & 0x02)
+		{
+			plot(cx + dx + x, cy - y, color);
+			plot(cx + dx + y, cy - x, color);
+		}
+		if (corners & 0x04)
+		{
+			plot(cx + dx + y, cy + dy + x, color);
+			plot(cx + dx + x, cy + dy + y, color);
+		}
+		if (corners & 0x08)
+		{
+			plot(cx - x, cy + dy + y, color);
+			plot(cx - y, cy + dy + x, color);
+		}
+		if (f >= 0)
+		{
+			y--;
+			ddy += 2;
+			f += ddy;
+		}
+		x++;
+		ddx += 2;
+		f += ddx;
+	}
+}
+
+void ssd1309_drawRoundRect(int x, UINT8 y, UINT8 w, UINT8 h, UINT8 r, UINT8 color)
+{
+	if ((w == 0) || (h == 0))
+	{
+		return;
+	}
+	if (r > (w-1)/2)						// the corners must fit
+	{
+		r = (w-1)/2;
+	}
+	if (r > (h-1)/2)
+	{
+		r = (h-1)/2;
+	}
+	spanH((int)x+r, (int)x+w-1-r, y, color);
+	spanH((int)x+r, (int)x+w-1-r, (int)y+h-1, color);
+	spanV(x, (int)y+r, (int)y+h-1-r, color);
+	spanV((int)x+w-1, (int)y+r, (int)y+h-1-r, color);
+	drawArcs((int)x+r, (int)y+r, r, 0x0F, w-1-2*r, h-1-2*r, color);
+}
+
+void ssd1309_drawCircle(int cx, UINT8 cy, UINT8 r, UINT8 color)
+{
+	drawArcs(cx, cy, r, 0x0F, 0, 0, color);
+}
+
+void ssd1309_fillCircle(int cx, UINT8 cy, UINT8 r, UINT8 color)
+{
+	int f = 1 - r;
+	int ddx = 1;
+	int ddy = -2 * (int)r;
+	int x = 0;
+	int y = r;
+	
+	spanV(cx, (int)cy-r, (int)cy+r, color);
+	while (x < y)
+	{
+		if (f >= 0)
+		{
+			y--;
+			ddy += 2;
+			f += ddy;
+		}
+		x++;
+		ddx += 2;
+		f += ddx;
+		spanV((int)cx+x, (int)cy-y, (int)cy+y, color);	// vertical spans, the inner pages are whole bytes
+		spanV((int)cx-x, (int)cy-y, (int)cy+y, color);
+		spanV((int)cx+y, (int)cy-x, (int)cy+x, color);
+		spanV((int)cx-y, (int)cy-x, (int)cy+x, color);
+	}
+}
+
+/**
+  * @brief  returns the buffer bytes of a page, NULL if the page is not in the buffer
+  */
+static UINT8* bufPage(UINT8 page)
+{
+#ifdef SSD1309_FRAMEBUFFER
+	return (page < SSD1309_PAGES) ? framebuffer[page] : NULL;
+#else
+	return inStrip(page) ? strip[page-stripPage] : NULL;
+#endif
+}
+
+/**
+  * @brief  combines one row of source bytes with the masked bits of a buffer page
+  *
+  * @param	page	the destination page
+  * @param  column	first destination column
+  * @param  *src	the source bytes, may point to program memory
+  * @param  len		number of bytes
+  * @param  shift	0-7 shifts the source bits down the page, -1..-7 shifts them up
+  *					to take the bits that spill over from the page above
+  * @param  mask	the destination bits covered by the source
+  * @param  rop		one of the SSD1309_ROP_* operations
+  */
+static void blitPage(UINT8 page, UINT8 column, const UINT8 *src, UINT8 len, int8_t shift, UINT8 mask, UINT8 rop)
+{
+	UINT8 *ptr = bufPage(page);
+	UINT8 value, old;
+#ifdef SSD1309_FRAMEBUFFER
+	UINT8 first = SSD1309_COL, last = 0;
+#endif
+
+	if (ptr == NULL)
+	{
+		return;
+	}
+	ptr += column;
+	if ((shift == 0) && (mask == 0xFF) && (rop == SSD1309_ROP_COPY))	// aligned copy, no bit operations
+	{
+#ifdef SSD1309_FRAMEBUFFER
+		for(;len;len--,column++,ptr++,src++)
+		{
+			value = pgm_read_byte(src);
+			if (*ptr != value)
+			{
+				*ptr = value;
+				if (first == SSD1309_COL)
+				{
+					first = column;
+				}
+				last = column;
+			}
+		}
+		if (first != SSD1309_COL)
+		{
+			setDirty(page, first, last);
+		}
+#else
+		while (len--)
+		{
+			*ptr++ = pgm_read_byte(src++);
+		}
+#endif
+		return;
+	}
+	for(;len;len--,column++,ptr++,src++)
+	{
+		value = pgm_read_byte(src);
+		value = (shift >= 0) ? (UINT8)(value << shift) : (value >> -shift);
+		old = *ptr;
+		switch (rop)
+		{
+			case SSD1309_ROP_OR:	*ptr = old | (value & mask); break;
+			case SSD1309_ROP_AND:	*ptr = old & (value | ~mask); break;
+			case SSD1309_ROP_XOR:	*ptr = old ^ (value & mask); break;
+			default:				*ptr = (old & ~mask) | (value & mask); break;
+		}
+#ifdef SSD1309_FRAMEBUFFER
+		if (*ptr != old)
+		{
+			if (first == SSD1309_COL)
+			{
+				first = column;
+			}
+			last = column;
+		}
+#endif
+	}
+#ifdef SSD1309_FRAMEBUFFER
+	if (first != SSD1309_COL)
+	{
+		setDirty(page, first, last);
+	}
+#endif
+}
+
+void ssd1309_blit(const UINT8 *src, UINT8 srcW, UINT8 srcH, UINT8 x, UINT8 y, UINT8 rop)
+{
+	UINT8 srcPage, srcPages, page, w, rows;
+	UINT8 shift = y%8;
+	
+	if ((x >= SSD1309_COL) || (y >= SSD1309_ROW) || (srcW == 0) || (srcH == 0))
+	{
+		return;
+	}
+	w = (srcW > (SSD1309_COL - x)) ? (SSD1309_COL - x) : srcW;	// clip at the right edge
+	srcPages = (srcH+7)/8;
+	page = y/8;
+	for(srcPage=0;srcPage<srcPages;srcPage++,page++,src+=srcW)
+	{
+		rows = (srcPage == (srcPages-1)) ? (srcH - srcPage*8) : 8;	// the last source page may be partial
+		blitPage(page, x, src, w, shift, (UINT8)((0xFF >> (8-rows)) << shift), rop);
+		if (shift && ((rows + shift) > 8))							// bits that spill into the next page
+		{
+			blitPage(page+1, x, src, w, shift-8, (0xFF >> (8-rows)) >> (8-shift), rop);
+		}
+	}
+}
+
+#endif
+
+#ifdef SSD1309_FRAMEBUFFER
+
+UINT8* ssd1309_getFramebuffer(void)
+{
+	return &framebuffer[0][0];
+}
+
+void ssd1309_markDirty(UINT8 page, UINT8 startCol, UINT8 endCol)
+{
+	if ((page < SSD1309_PAGES) && (startCol <= endCol) && (endCol < SSD1309_COL))
+	{
+		setDirty(page, startCol, endCol);
+	}
+}
+
+/**
+  * @brief  returns the last page that can share one window with the given dirty page
+  *
+  *			Following pages with exactly the same dirty span are streamed in the same
+  *			horizontal mode window, so a full frame is still one single stream.
+  *
+  * @param	*spanMin	first column per page, dirtyMin or flushMin
+  * @param	*spanMax	last column per page, dirtyMax or flushMax
+  * @param	page		the first page of the window
+  */
+static UINT8 windowEnd(const UINT8 *spanMin, const UINT8 *spanMax, UINT8 page)
+{
+	while ((page < (SSD1309_PAGES-1)) && (spanMin[page+1] == spanMin[page]) && (spanMax[page+1] == spanMax[page]))
+	{
+		page++;
+	}
+	return page;
+}
+
+UINT16 ssd1309_flushBytes(void)
+{
+	UINT8 spanMin[SSD1309_PAGES];					// the spans the next flush will send
+	UINT8 spanMax[SSD1309_PAGES];
+	UINT8 page, last;
+	UINT16 bytes = 0;
+
+	for(page=0;page<SSD1309_PAGES;page++)		// unsent spans of a running flush are sent again
+	{
+		spanMin[page] = (dirtyMin[page] < flushMin[page]) ? dirtyMin[page] : flushMin[page];
+		spanMax[page] = (dirtyMax[page] > flushMax[page]) ? dirtyMax[page] : flushMax[page];
+	}
+	if (scrollActive)								// the flush stops the scrolling and restores its pages
+	{
+		for(page=scrollStartPage;page<=scrollEndPage;page++)
+		{
+			spanMin[page] = 0;
+			spanMax[page] = SSD1309_COL-1;
+		}
+		bytes = 1;									// Deactivate Scroll
+	}
+	for(page=0;page<SSD1309_PAGES;page=last+1)
+	{
+		last = page;
+		if (spanMin[page] > spanMax[page])			// clean page
+		{
+			continue;
+		}
+		last = windowEnd(spanMin, spanMax, page);
+		bytes += 6 + (UINT16)(last-page+1) * (spanMax[page]-spanMin[page]+1);
+	}
+	if ((bytes > 1) && (addrMode != 0))
+	{
+		bytes += 2;									// addressing mode
+	}
+	return bytes;
+}
+
+/**
+  * @brief  moves the flush on to the next page that has something to send
+  */
+static void flushNextPage(void)
+{
+	flushMin[flushPage] = SSD1309_COL;				// page done
+	flushMax[flushPage] = 0;
+	if (flushPage >= flushLast)
+	{
+		flushOpen = false;
+	}
+	flushPage++;
+	while ((flushPage < SSD1309_PAGES) && (flushMin[flushPage] > flushMax[flushPage]))
+	{
+		flushPage++;
+	}
+	if (flushPage < SSD1309_PAGES)
+	{
+		flushCol = flushMin[flushPage];
+	}
+}
+
+void ssd1309_flush_begin(void)
+{
+	UINT8 page;
+
+	if (scrollActive)								// before the dirty spans are read
+	{
+		scrollOff();
+	}
+	for(page=0;page<SSD1309_PAGES;page++)		// unsent spans of a running flush stay in
+	{
+		if (dirtyMin[page] < flushMin[page])
+		{
+			flushMin[page] = dirtyMin[page];
+		}
+		if (dirtyMax[page] > flushMax[page])
+		{
+			flushMax[page] = dirtyMax[page];
+		}
+	}
+	setClean();
+	flushOpen = false;
+	flushLast = 0;
+	flushPage = 0;
+	flushCol = flushMin[0];
+	if (flushMin[0] > flushMax[0])
+	{
+		flushNextPage();
+	}
+}
+
+bool ssd1309_flush_step(UINT16 maxBytes)
+{
+	UINT8 len;
+
+	if (scrollActive)								// started after ssd1309_flush_begin()
+	{
+		scrollOff();
+	}
+	while ((flushPage < SSD1309_PAGES) && maxBytes)
+	{
+		if (!flushOpen)
+		{
+			if (flushCol == flushMin[flushPage])	// whole page span, following pages may share the window
+			{
+				flushLast = windowEnd(flushMin, flushMax, flushPage);
+				setWindow(flushMin[flushPage], flushMax[flushPage], flushPage, flushLast);
+			}
+			else									// rest of a page that was cut by the budget
+			{
+				flushLast = flushPage;
+				setWindow(flushCol, flushMax[flushPage], flushPage, flushPage);
+			}
+			flushOpen = true;
+		}
+		len = flushMax[flushPage] - flushCol + 1;
+		if (len > maxBytes)
+		{
+			len = (UINT8)maxBytes;
+		}
+		ssd1309_bus_writeDataBurst(&framebuffer[flushPage][flushCol], len);
+		maxBytes -= len;
+		flushCol += len;
+		if (flushCol > flushMax[flushPage])
+		{
+			flushNextPage();
+		}
+	}
+	return (flushPage >= SSD1309_PAGES);
+}
+
+void ssd1309_flush(void)
+{
+	ssd1309_flush_begin();
+	while (!ssd1309_flush_step(0xFFFF));
+}
+
+#if (SSD1309_PAGES >= 8)							// only the console ring over 8 pages needs it
+
+/**
+  * @brief  sends the dirty span of one page right away, the other pages wait for the next flush
+  *
+  * @param	page	the page
+  */
+static void sendPage(UINT8 page)
+{
+	if ((page >= SSD1309_PAGES) || (dirtyMin[page] > dirtyMax[page]))
+	{
+		return;
+	}
+	setWindow(dirtyMin[page], dirtyMax[page], page, page);
+	ssd1309_bus_writeDataBurst(&framebuffer[page][dirtyMin[page]], dirtyMax[page]-dirtyMin[page]+1);
+	dirtyMin[page] = SSD1309_COL;
+	dirtyMax[page] = 0;
+	flushOpen = false;								// a running flush has to open its window again
+}
+
+#endif
+
+#endif
+
+#ifdef SSD1309_STRIP
+
+void ssd1309_renderStrips(void (*draw)(UINT8 startPage, UINT8 endPage))
+{
+	UINT8 endPage;
+
+	setWindow(0, SSD1309_COL-1, 0, SSD1309_PAGES-1);	// the strips follow each other in one window
+	for(stripPage=0;stripPage<SSD1309_PAGES;stripPage+=SSD1309_STRIP_PAGES)
+	{
+		endPage = stripPage + SSD1309_STRIP_PAGES - 1;
+		if (endPage >= SSD1309_PAGES)
+		{
+			endPage = SSD1309_PAGES-1;
+		}
+		memset(strip, 0x00, sizeof(strip));
+		draw(stripPage, endPage);
+		ssd1309_bus_writeDataBurst(&strip[0][0], (UINT16)(endPage-stripPage+1) * SSD1309_COL);
+	}
+}
+
+#endif
+
+/**
+  * @brief  returns the index of a char in the font tables
+  *
+  * @param	aChar	the ASCII or extended char, chars without glyph become a ?
+  */
+static UINT8 fontIndex(unsigned char aChar)
+{
+	if((aChar >= 0x20) && (aChar <= 0x7E))	// normal ASCII Char
+	{
+		aChar -= 0x20;						// subtract to match index
+	}
+	else if (aChar >= 0xA0)					// extended UTF8 char
+	{
+		aChar -= 0x41;						// subtract to match index
+	}
+	else									// char not available
+	{
+		aChar = '?' - 0x20;					// make a ?
+	}	
+	return aChar;
+}
+
+void ssd1309_putc(unsigned char aChar, UINT8 page, UINT8 startColumn)
+{
+	aChar = fontIndex(aChar);
+	
+	gotoPos(page, startColumn);
+	putDataBurst((const UINT8*)font[aChar], 5);
+	putData(0);
+}
+
+/**
+  * @brief  returns the width of a proportional glyph in columns
+  *
+  * @param	index	the index of the glyph, see fontIndex()
+  */
+static UINT8 propWidth(UINT8 index)
+{
+	return (UINT8)(pgm_read_word(&propFontIndex[index+1]) - pgm_read_word(&propFontIndex[index]));
+}
+
+UINT8 ssd1309_putcProp(unsigned char aChar, UINT8 page, UINT8 startColumn)
+{
+	UINT8 index = fontIndex(aChar);
+	UINT8 width = propWidth(index);
+	
+	gotoPos(page, startColumn);
+	putDataBurst(&propFont[pgm_read_word(&propFontIndex[index])], width);
+	return width;
+}
+
+UINT8 ssd1309_printProp(const char *aString, UINT8 page, UINT8 startColumn)
+{
+	UINT8 index, width;
+	UINT8 column = startColumn;
+	
+	gotoPos(page, startColumn);				// the glyphs follow each other, one position for all
+	while(*aString != '\0')
+	{
+		index = fontIndex((unsigned char)*aString);
+		width = propWidth(index);
+		if (column != startColumn)			// one blank column between two glyphs
+		{
+			width++;
+		}
+		if (width > (SSD1309_COL - column))	// stop at the right edge instead of wrapping
+		{
+			break;
+		}
+		if (column != startColumn)
+		{
+			putData(0);
+			width--;
+			column++;
+		}
+		putDataBurst(&propFont[pgm_read_word(&propFontIndex[index])], width);
+		column += width;
+		aString++;
+	}
+	return column;
+}
+
+UINT8 ssd1309_textWidthProp(const char *aString)
+{
+	UINT16 width = 0;
+	
+	while(*aString != '\0')
+	{
+		width += propWidth(fontIndex((unsigned char)*aString)) + 1;
+		aString++;
+	}
+	if (width)
+	{
+		width--;							// no blank column after the last glyph
+	}
+	return (width > 255) ? 255 : (UINT8)width;
+}
+
+void ssd1309_putBigDigit(unsigned char aDigit, UINT8 page, UINT8 startColumn)
+{
+	if((aDigit >= '+') && (aDigit <= '9'))			// Digit is printable
+	{
+		gotoPos(page, startColumn);		
+		putDataBurst((const UINT8*)&bigDigit[(aDigit-'+')][0], 13);
+		putDataFill(0, 2);
+		
+		gotoPos(page+1, startColumn);
+		putDataBurst((const UINT8*)&bigDigit[(aDigit-'+')][13], 13);
+		putDataFill(0, 2);
+	}
+	else								// make a whitespace
+	{
+		gotoPos(page, startColumn);		
+		putDataFill(0, 15);
+		
+		gotoPos(page+1, startColumn);
+		putDataFill(0, 15);
+	}		
+}
+
+
+void ssd1309_print(char *aString, UINT8 page, UINT8 startColumn)
+{
+	char * Src_Pointer = aString;			// copy the pointer, because will will increment it
+		
+	while(*Src_Pointer != '\0')				// until string end
+	{
+		ssd1309_putc((unsigned char)*Src_Pointer, page, startColumn);
+		Src_Pointer++;
+		startColumn+=6;
+	}
+}
+
+void ssd1309_print_bigDigit(char *aString, UINT8 page, UINT8 startColumn)
+{
+	char * Src_Pointer = aString;			// copy the pointer, because will will increment it
+		
+	while(*Src_Pointer != '\0')				// until string end
+	{
+		ssd1309_putBigDigit((unsigned char)*Src_Pointer, page, startColumn);
+		Src_Pointer++;
+		startColumn+=15;
+	}
+}
+
+void ssd1309_print_P(const char* aString, UINT8 page, UINT8 startColumn)
+{
+	UINT8 tmp;
+	const char* Src_Pointer = aString;			// copy the pointer, because will will increment it	
+	
+	tmp = pgm_read_byte(Src_Pointer);
+	while(tmp != '\0')
+	{
+		ssd1309_putc(tmp, page, startColumn);
+		Src_Pointer++;
+		tmp = pgm_read_byte(Src_Pointer);
+		startColumn+=6;
+	}
+}
+
+#define FMT_LEFT	0x01				// '-' flag, pad on the right side
+#define FMT_ZERO	0x02				// '0' flag, pad with zeros instead of blanks
+#define FMT_LONG	0x04				// 'l' length modifier, the argument is a long
+#define FMT_HEX		0x08				// %x and %X
+#define FMT_UPPER	0x10				// %X
+
+static const UINT32 fmtPow10[10] =		// MSB first digit extraction without a division
+{
+	1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+static UINT8 fmtColumn;					// column of the next glyph, SSD1309_COL = line full
+
+/**
+  * @brief  writes one glyph of the small font at the formatter position
+  *
+  *			The display position is set once by fmtPrint(), the glyphs follow each other.
+  */
+static void fmtPutc(unsigned char aChar)
+{
+	if (fmtColumn > (SSD1309_COL - 6))	// stop at the right edge instead of wrapping
+	{
+		fmtColumn = SSD1309_COL;
+		return;
+	}
+	putDataBurst((const UINT8*)font[fontIndex(aChar)], 5);
+	putData(0);
+	fmtColumn += 6;
+}
+
+/**
+  * @brief  writes the padding chars of a field
+  *
+  * @param	aChar	the padding char
+  * @param	width	the field width
+  * @param	len		number of chars of the field content
+  */
+static void fmtPad(unsigned char aChar, UINT8 width, UINT8 len)
+{
+	while (width > len)
+	{
+		fmtPutc(aChar);
+		width--;
+	}
+}
+
+/**
+  * @brief  writes a number, the digits are emitted MSB first without a buffer
+  *
+  * @param	value		the magnitude of the number
+  * @param	negative	true = a minus sign is written in front of the number
+  * @param	flags		FMT_* flags of the conversion
+  * @param	width		the minimum field width
+  * @param	point		number of decimal places for fixed-point numbers, 0 = integer
+  */
+static void fmtNumber(UINT32 value, bool negative, UINT8 flags, UINT8 width, UINT8 point)
+{
+	UINT8 digits = 1;
+	UINT8 len, digit;
+	
+	if (flags & FMT_HEX)
+	{
+		while ((digits < 8) && (value >> (digits*4)))
+		{
+			digits++;
+		}
+	}
+	else
+	{
+		while ((digits < 10) && (value >= fmtPow10[digits]))
+		{
+			digits++;
+		}
+	}
+	if (point && (digits <= point))		// leading zero of 0.xx
+	{
+		digits = point+1;
+	}
+	len = digits + (point ? 1 : 0) + (negative ? 1 : 0);
+	
+	if (!(flags & (FMT_LEFT | FMT_ZERO)))
+	{
+		fmtPad(' ', width, len);
+	}
+	if (negative)
+	{
+		fmtPutc('-');
+	}
+	if ((flags & (FMT_LEFT | FMT_ZERO)) == FMT_ZERO)
+	{
+		fmtPad('0', width, len);
+	}
+	while (digits--)
+	{
+		if (flags & FMT_HEX)
+		{
+			digit = (UINT8)(value >> (digits*4)) & 0x0F;
+			digit += (digit < 10) ? '0' : (((flags & FMT_UPPER) ? 'A' : 'a') - 10);
+		}
+		else
+		{
+			digit = '0';
+			while (value >= fmtPow10[digits])
+			{
+				value -= fmtPow10[digits];
+				digit++;
+			}
+		}
+		fmtPutc(digit);
+		if (point && (digits == point))
+		{
+			fmtPutc('.');
+		}
+	}
+	if (flags & FMT_LEFT)
+	{
+		fmtPad(' ', width, len);
+	}
+}
+
+/**
+  * @brief  formats and writes a string at specified position
+  *
+  * @param  page		the page (line) where the string is displayed
+  * @param  startColumn	the column where the string starts
+  * @param	*fmt		the format string, read with pgm_read_byte()
+  * @param	args		the arguments of the conversions
+  */
+static void fmtPrint(UINT8 page, UINT8 startColumn, const char *fmt, va_list args)
+{
+	unsigned char aChar;
+	const char *aString;
+	UINT8 flags, width, point, len;
+	long number;
+	
+	gotoPos(page, startColumn);				// the glyphs follow each other, one position for all
+	fmtColumn = startColumn;
+	
+	while ((aChar = pgm_read_byte(fmt++)) != '\0')
+	{
+		if (aChar != '%')
+		{
+			fmtPutc(aChar);
+			continue;
+		}
+		
+		flags = 0;
+		width = 0;
+		point = 0;
+		for (;;)							// flags
+		{
+			aChar = pgm_read_byte(fmt++);
+			if (aChar == '-')
+			{
+				flags |= FMT_LEFT;
+			}
+			else if (aChar == '0')
+			{
+				flags |= FMT_ZERO;
+			}
+			else
+			{
+				break;
+			}
+		}
+		while ((aChar >= '0') && (aChar <= '9'))	// width
+		{
+			width = width*10 + (aChar - '0');
+			aChar = pgm_read_byte(fmt++);
+		}
+		if (aChar == '.')					// decimal places of %q
+		{
+			aChar = pgm_read_byte(fmt++);
+			while ((aChar >= '0') && (aChar <= '9'))
+			{
+				point = point*10 + (aChar - '0');
+				aChar = pgm_read_byte(fmt++);
+			}
+			if (point > 9)
+			{
+				point = 9;
+			}
+		}
+		if (aChar == 'l')
+		{
+			flags |= FMT_LONG;
+			aChar = pgm_read_byte(fmt++);
+		}
+		
+		switch (aChar)
+		{
+			case 'd':
+			case 'i':
+				point = 0;
+				/* fall through */
+			case 'q':
+				number = (flags & FMT_LONG) ? va_arg(args, long) : va_arg(args, int);
+				fmtNumber((number < 0) ? (UINT32)0 - (UINT32)number : (UINT32)number, (number < 0), flags, width, point);
+				break;
+			case 'X':
+				flags |= FMT_UPPER;
+				/* fall through */
+			case 'x':
+				flags |= FMT_HEX;
+				/* fall through */
+			case 'u':
+				fmtNumber((flags & FMT_LONG) ? va_arg(args, unsigned long) : va_arg(args, unsigned int), false, flags, width, 0);
+				break;
+			case 'c':
+				len = 1;
+				if (!(flags & FMT_LEFT))
+				{
+					fmtPad(' ', width, len);
+				}
+				fmtPutc((unsigned char)va_arg(args, int));
+				if (flags & FMT_LEFT)
+				{
+					fmtPad(' ', width, len);
+				}
+				break;
+			case 's':
+				aString = va_arg(args, const char*);
+				len = (UINT8)strlen(aString);
+				if (!(flags & FMT_LEFT))
+				{
+					fmtPad(' ', width, len);
+				}
+				while (*aString != '\0')
+				{
+					fmtPutc((unsigned char)*aString++);
+				}
+				if (flags & FMT_LEFT)
+				{
+					fmtPad(' ', width, len);
+				}
+				break;
+			case '\0':						// format string ends inside a conversion
+				return;
+			default:						// %% and unknown conversions print the char
+				fmtPutc(aChar);
+				break;
+		}
+	}
+}
+
+void ssd1309_printf(UINT8 page, UINT8 startColumn, const char* __fmt, ...)
+{
+	va_list argumentlist;
+	va_start(argumentlist, __fmt);
+	fmtPrint(page, startColumn, __fmt, argumentlist);
+	va_end(argumentlist);
+}
+
+void ssd1309_printf_P(UINT8 page, UINT8 startColumn, const char* __fmt, ...)
+{
+	va_list argumentlist;
+	va_start(argumentlist, __fmt);
+	fmtPrint(page, startColumn, __fmt, argumentlist);
+	va_end(argumentlist);
+}
+
+#ifndef SSD1309_STRIP
+
+#define CONSOLE_COLS	(SSD1309_COL/6)		// chars per console line
+#define CONSOLE_LINES	SSD1309_PAGES		// console lines on the panel
+#define CONSOLE_PAGES	8					// GDDRAM pages the display start line rotates through
+
+static UINT8 consoleTop;				// GDDRAM page shown in the first line
+static UINT8 consoleLine;				// line of the cursor, 0 = first line
+static UINT8 consoleCol;				// column of the cursor in chars
+static UINT8 consoleEnd;				// chars up to here may be set in the cursor line, the rest is blank
+static bool consoleSynced;				// the display position follows the cursor
+
+/**
+  * @brief  returns the GDDRAM page of the cursor line
+  */
+static UINT8 consolePage(void)
+{
+	return (consoleTop + consoleLine) % CONSOLE_PAGES;
+}
+
+/**
+  * @brief  clears the cursor line from the cursor to the end of the written text
+  */
+static void consoleClearEol(void)
+{
+	if (consoleCol < consoleEnd)
+	{
+		gotoPos(consolePage(), consoleCol*6);
+		putDataFill(0, (consoleEnd-consoleCol)*6);
+		consoleSynced = false;
+	}
+	consoleEnd = consoleCol;
+}
+
+/**
+  * @brief  moves the cursor to the start of the next line, at the last line the display start line moves on by one page
+  *
+  *			A framebuffer with less than 8 pages can not back the ring, there the lines
+  *			are moved up in the buffer and sent with the next flush.
+  */
+static void consoleNewLine(void)
+{
+#if defined(SSD1309_FRAMEBUFFER) && (SSD1309_PAGES < CONSOLE_PAGES)
+	UINT8 page;
+
+#endif
+	consoleClearEol();
+	consoleCol = 0;
+	consoleEnd = 0;
+	consoleSynced = false;
+	if (consoleLine < (CONSOLE_LINES-1))
+	{
+		consoleLine++;
+		return;
+	}
+#if defined(SSD1309_FRAMEBUFFER) && (SSD1309_PAGES < CONSOLE_PAGES)
+	memmove(framebuffer[0], framebuffer[1], (SSD1309_PAGES-1)*SSD1309_COL);	// the buffer can not hold the ring, the lines move up instead
+	for(page=0;page<(SSD1309_PAGES-1);page++)
+	{
+		setDirty(page, 0, SSD1309_COL-1);
+	}
+	gotoPos(consolePage(), 0);
+	putDataFill(0, SSD1309_COL);
+	consoleSynced = true;
+#else
+	consoleTop = (consoleTop+1) % CONSOLE_PAGES;
+	gotoPos(consolePage(), 0);			// the new line still holds the oldest line, clear it before it is shown
+	putDataFill(0, SSD1309_COL);
+	consoleSynced = true;				// the column wrapped back to the start of the line
+#ifdef SSD1309_FRAMEBUFFER
+	sendPage(consolePage());			// the panel must not show the old line at the bottom
+#endif
+	cmd_StartLine(consoleTop*8);
+#endif
+}
+
+/**
+  * @brief  writes one char at the cursor
+  */
+static void consolePutc(unsigned char aChar)
+{
+	if (aChar == '\n')
+	{
+		consoleNewLine();
+	}
+	else if (aChar == '\r')
+	{
+		consoleClearEol();
+		consoleCol = 0;
+		consoleSynced = false;
+	}
+	else
+	{
+		if (consoleCol >= CONSOLE_COLS)	// wrap
+		{
+			consoleNewLine();
+		}
+		if (!consoleSynced)
+		{
+			gotoPos(consolePage(), consoleCol*6);
+			consoleSynced = true;
+		}
+		putDataBurst((const UINT8*)font[fontIndex(aChar)], 5);
+		putData(0);
+		consoleCol++;
+		if (consoleCol > consoleEnd)
+		{
+			consoleEnd = consoleCol;
+		}
+	}
+}
+
+void ssd1309_console_clear(void)
+{
+	ssd1309_clear();
+	cmd_StartLine(0);
+	consoleTop = 0;
+	consoleLine = 0;
+	consoleCol = 0;
+	consoleEnd = 0;
+}
+
+void ssd1309_console_putc(char aChar)
+{
+	consoleSynced = false;				// other functions may have moved the display position
+	consolePutc((unsigned char)aChar);
+}
+
+void ssd1309_console_puts(const char *aString)
+{
+	consoleSynced = false;
+	while (*aString != '\0')
+	{
+		consolePutc((unsigned char)*aString++);
+	}
+}
+
+#endif
+
+void ssd1309_showPic(const UINT8 *pic, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol)
+{
+	UINT8 i;
+	
+	for(i=startPage;i<=endPage;i++)
+	{
+		gotoPos(i, startCol);
+		putDataBurst(pic+(i-startPage)*totalCol, totalCol);
+	}
+}
+
+/**
+  * @brief  draws a run length compressed picture, see ssd1309_showPicRLE()
+  *
+  *			Pages below the panel are decoded without drawing them.
+  *
+  * @param	*rle		pointer to the compressed picture
+  * @param  startPage	the page where the picture starts
+  * @param  startCol	x offset for display position
+  * @return	the first byte behind the compressed picture
+  */
+static const UINT8* rleDecode(const UINT8 *rle, UINT8 startPage, UINT8 startCol)
+{
+	UINT8 width = pgm_read_byte(rle++);
+	UINT8 pages = pgm_read_byte(rle++);
+	UINT8 page = startPage;
+	UINT8 col = 0;
+	UINT8 token, value, len, n;
+
+	if ((width == 0) || (pages == 0))
+	{
+		return rle;
+	}
+	gotoPos(page, startCol);
+	for(;;)
+	{
+		token = pgm_read_byte(rle++);
+		value = 0x00;
+		if (token >= SSD1309_RLE_RUN)
+		{
+			value = pgm_read_byte(rle++);
+		}
+		len = (token < SSD1309_RLE_ZEROS) ? (token + 1) : ((token & 0x3F) + 1);
+		while (len)
+		{
+			n = ((width - col) < len) ? (width - col) : len;	// the runs are split at the page end
+			if (page >= SSD1309_PAGES)						// below the bottom edge
+			{
+				if (token < SSD1309_RLE_ZEROS)
+				{
+					rle += n;
+				}
+			}
+			else if (token < SSD1309_RLE_ZEROS)
+			{
+				putDataBurst(rle, n);							// literal bytes, straight from the stream
+				rle += n;
+			}
+			else
+			{
+				putDataFill(value, n);
+			}
+			len -= n;
+			col += n;
+			if (col == width)
+			{
+				if (--pages == 0)
+				{
+					return rle;
+				}
+				col = 0;
+				if (++page < SSD1309_PAGES)
+				{
+					gotoPos(page, startCol);
+				}
+			}
+		}
+	}
+}
+
+void ssd1309_showPicRLE(const UINT8 *rle, UINT8 startPage, UINT8 startCol)
+{
+	rleDecode(rle, startPage, startCol);
+}
+
+void ssd1309_showPicWindow(const UINT8 *pic, UINT16 picWidth, UINT16 picHeight, UINT16 srcX, UINT16 srcY, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol)
+{
+	UINT8 buf[16];
+	UINT8 page, width, visible, len, i, mask;
+	UINT8 shift = srcY%8;
+	UINT16 row = srcY;
+	const UINT8 *src;
+	bool next;
+
+	if ((startPage >= SSD1309_PAGES) || (startCol >= SSD1309_COL) || (endPage < startPage) || (endCol < startCol))
+	{
+		return;
+	}
+	if (endPage >= SSD1309_PAGES)							// clip at the panel edges
+	{
+		endPage = SSD1309_PAGES - 1;
+	}
+	if (endCol >= SSD1309_COL)
+	{
+		endCol = SSD1309_COL - 1;
+	}
+	width = endCol - startCol + 1;
+	visible = 0;
+	if (srcX < picWidth)									// columns taken from the picture
+	{
+		visible = ((picWidth - srcX) < width) ? (UINT8)(picWidth - srcX) : width;
+	}
+	for(page=startPage;page<=endPage;page++,row+=8)
+	{
+		gotoPos(page, startCol);
+		if ((row < picHeight) && visible)
+		{
+			src = pic + (UINT32)(row/8)*picWidth + srcX;
+			mask = ((picHeight - row) < 8) ? (0xFF >> (8 - (picHeight - row))) : 0xFF;
+			next = shift && (((row/8) + 1) < ((picHeight+7)/8));
+			if ((shift == 0) && (mask == 0xFF))
+			{
+				putDataBurst(src, visible);					// aligned, streams straight from the picture
+			}
+			else
+			{
+				for(len=visible;len;len-=i)					// merges two source pages in chunks
+				{
+					for(i=0;(i<sizeof(buf))&&(i<len);i++,src++)
+					{
+						buf[i] = pgm_read_byte(src) >> shift;
+						if (next)
+						{
+							buf[i] |= (UINT8)(pgm_read_byte(src+picWidth) << (8-shift));
+						}
+						buf[i] &= mask;
+					}
+					putDataBurst(buf, i);
+				}
+			}
+			putDataFill(0x00, width - visible);				// right of the picture
+		}
+		else
+		{
+			putDataFill(0x00, width);						// below the picture
+		}
+	}
+}
+
+#ifndef SSD1309_STRIP
+
+void ssd1309_anim_init(ssd1309_anim_t *anim, const UINT8 *data, UINT8 page, UINT8 col)
+{
+	anim->data = data;
+	anim->frames = pgm_read_byte(data);
+	anim->period = pgm_read_byte(data+1) | ((UINT16)pgm_read_byte(data+2) << 8);
+	anim->page = page;
+	anim->col = col;
+	anim->frame = 0;
+	anim->timed = false;
+	anim->next = rleDecode(data+3, page, col);				// the key frame
+	anim->first = anim->next;
+}
+
+UINT8 ssd1309_anim_next(ssd1309_anim_t *anim)
+{
+	const UINT8 *ptr = anim->next;
+	UINT8 spans = pgm_read_byte(ptr++);
+	UINT8 page, col, len;
+
+	while (spans--)
+	{
+		page = anim->page + pgm_read_byte(ptr++);
+		col = anim->col + pgm_read_byte(ptr++);
+		len = pgm_read_byte(ptr++);
+		if (page < SSD1309_PAGES)
+		{
+			gotoPos(page, col);
+			putDataBurst(ptr, len);
+		}
+		ptr += len;
+	}
+	if (++anim->frame >= anim->frames)						// the last delta leads back to the key frame
+	{
+		anim->frame = 0;
+		ptr = anim->first;
+	}
+	anim->next = ptr;
+	return anim->frame;
+}
+
+bool ssd1309_anim_poll(ssd1309_anim_t *anim, UINT16 tick)
+{
+	UINT16 elapsed = tick - anim->tick;					// wraps correctly
+
+	if (!anim->timed)										// the key frame is shown from now on
+	{
+		anim->tick = tick;
+		anim->timed = true;
+		return false;
+	}
+	if (elapsed < anim->period)
+	{
+		return false;
+	}
+	if (elapsed < 2*anim->period)
+	{
+		anim->tick += anim->period;							// keeps the frame rate, the poll may come late
+	}
+	else
+	{
+		anim->tick = tick;									// more than a frame behind, drop the lost time
+	}
+	ssd1309_anim_next(anim);
+	return true;
+}
+
+#endif
+
+/**
+  * @brief  returns the frame byte of a bar graph page, the outer frame lines of the first and last page
+  */
+static UINT8 barFrame(UINT8 page, UINT8 startPage, UINT8 endPage)
+{
+	return ((page == startPage) ? 0x01 : 0x00) | ((page == endPage) ? 0x80 : 0x00);
+}
+
+/**
+  * @brief  returns the byte of a filled column of a horizontal bar graph page, frame and gap included
+  */
+static UINT8 hBarFill(UINT8 page, UINT8 startPage, UINT8 endPage)
+{
+	return ((page == startPage) ? 0xFD : 0xFF) & ((page == endPage) ? 0xBF : 0xFF);
+}
+
+/**
+  * @brief  returns the byte of an inner column of a vertical bar graph page
+  *
+  * @param	page		the page of the byte
+  * @param  startPage	the page where the bar graph starts
+  * @param  endPage		the page where the bar graph ends
+  * @param  bar			the bar height in pixels
+  * @param  height		the bar graph height in pixels
+  */
+static UINT8 vBarByte(UINT8 page, UINT8 startPage, UINT8 endPage, UINT8 bar, UINT8 height)
+{
+	UINT8 dummy;
+	
+	if (page==startPage)
+	{
+		dummy = height - 4 - bar;
+		if (dummy > 6)
+		{
+			dummy = 6;
+		}
+		dummy = (0xFC<<dummy) | 0x01;
+	} 
+	else if (page==endPage)
+	{
+		if (bar >= 6)
+		{
+			dummy = 0;
+		}
+		else
+		{
+			dummy = 6-bar;
+		}
+		dummy = (0xFF<<dummy) & 0xBF;
+	} 
+	else
+	{
+		dummy = (endPage - page) * 8 + 6;
+		if (bar >= dummy)
+		{
+			dummy = 0;
+		}
+		else if ((bar + 8) <= dummy)
+		{
+			dummy = 8;
+		}
+		else
+		{
+			dummy = dummy - bar;
+		}
+		dummy = 0xFF<<dummy;
+	}
+	return dummy;
+}
+
+void ssd1309_drawBargraph(UINT8 percent, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol)
+{
+	UINT8 i, bar, frame;
+	
+	UINT8 height = ((endPage-startPage)*8+8);
 	
 	if (percent > 100)
 	{
@@ -791,58 +2692,13 @@ void ssd1309_drawBargraph(UINT8 percent, UINT8 startPage, UINT8 endPage, UINT8 s
 		bar = (UINT8)(((UINT16)(totalCol-4) * (UINT16)percent + 50) / 100);		
 		for(i=startPage;i<=endPage;i++)
 		{
-			cmd_PageStartAddress(i);
-			cmd_ColumnStartAddress(startCol);			
-			writeData(0xFF);			
-			if (endPage==startPage)
-			{
-				writeData(0x81);
-				for(j=0;j<bar;j++)
-				{
-					writeData(0xBD);
-				}
-				for(j=bar;j<(totalCol-3);j++)
-				{
-					writeData(0x81);
-				}
-			} 
-			else if (i==startPage)
-			{
-				writeData(0x01);
-				for(j=0;j<bar;j++)
-				{
-					writeData(0xFD);
-				}
-				for(j=bar;j<(totalCol-3);j++)
-				{
-					writeData(0x01);
-				}
-			}
-			else if (i==endPage)
-			{
-				writeData(0x80);
-				for(j=0;j<bar;j++)
-				{
-					writeData(0xBF);
-				}
-				for(j=bar;j<(totalCol-3);j++)
-				{
-					writeData(0x80);
-				}
-			}
-			else
-			{
-				writeData(0x00);
-				for(j=0;j<bar;j++)
-				{
-					writeData(0xFF);
-				}
-				for(j=bar;j<(totalCol-3);j++)
-				{
-					writeData(0x00);
-				}
-			}			
-			writeData(0xFF);
+			frame = barFrame(i, startPage, endPage);
+			gotoPos(i, startCol);			
+			putData(0xFF);			
+			putData(frame);
+			putDataFill(hBarFill(i, startPage, endPage), bar);
+			putDataFill(frame, totalCol-3-bar);
+			putData(0xFF);
 		}
 	} 
 	else										// height >= with -> vertical bar graph
@@ -855,89 +2711,561 @@ void ssd1309_drawBargraph(UINT8 percent, UINT8 startPage, UINT8 endPage, UINT8 s
 		bar = (UINT8)(((UINT16)(height-4) * (UINT16)percent + 50) / 100);		
 		for(i=startPage;i<=endPage;i++)
 		{
-			cmd_PageStartAddress(i);
-			cmd_ColumnStartAddress(startCol);			
-			writeData(0xFF);			
-			if (i==startPage)
+			frame = barFrame(i, startPage, endPage);
+			gotoPos(i, startCol);			
+			putData(0xFF);			
+			putData(frame);
+			putDataFill(vBarByte(i, startPage, endPage, bar, height), totalCol-4);
+			putData(frame);
+			putData(0xFF);			
+		}
+	}	
+}
+
+#ifndef SSD1309_STRIP
+
+void ssd1309_bargraph_init(ssd1309_bargraph_t *bargraph, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol)
+{
+	bargraph->startPage = startPage;
+	bargraph->endPage = endPage;
+	bargraph->startCol = startCol;
+	bargraph->totalCol = totalCol;
+	ssd1309_bargraph_invalidate(bargraph);
+}
+
+void ssd1309_bargraph_invalidate(ssd1309_bargraph_t *bargraph)
+{
+	bargraph->bar = 0xFF;
+}
+
+void ssd1309_bargraph_set(ssd1309_bargraph_t *bargraph, UINT8 percent)
+{
+	UINT8 i, bar, from, to, oldByte, newByte;
+	UINT8 startPage = bargraph->startPage;
+	UINT8 endPage = bargraph->endPage;
+	UINT8 totalCol = bargraph->totalCol;
+	UINT8 height = ((endPage-startPage)*8+8);
+	
+	if (percent > 100)
+	{
+		percent = 100;
+	}
+	if ((totalCol < 5) || ((totalCol <= height) && (startPage == endPage)))	// same limits as ssd1309_drawBargraph()
+	{
+		return;
+	}
+	
+	if (totalCol > height)
+	{
+		bar = (UINT8)(((UINT16)(totalCol-4) * (UINT16)percent + 50) / 100);
+	}
+	else
+	{
+		bar = (UINT8)(((UINT16)(height-4) * (UINT16)percent + 50) / 100);
+	}
+	
+	if (bargraph->bar == 0xFF)				// not on the display yet, draw the frame too
+	{
+		ssd1309_drawBargraph(percent, startPage, endPage, bargraph->startCol, totalCol);
+	}
+	else if (totalCol > height)				// horizontal: only the columns between old and new length
+	{
+		from = (bar < bargraph->bar) ? bar : bargraph->bar;
+		to = (bar < bargraph->bar) ? bargraph->bar : bar;
+		if (from != to)
+		{
+			for(i=startPage;i<=endPage;i++)
 			{
-				writeData(0x01);
-				dummy = height - 4 - bar;
-				if (dummy > 6)
-				{
-					dummy = 6;
-				}
-				dummy = (0xFC<<dummy) | 0x01;
-				for(j=2;j<(totalCol-2);j++)
-				{
-					writeData(dummy);
-				}
-				writeData(0x01);				
-			} 
-			else if (i==endPage)
+				gotoPos(i, bargraph->startCol+2+from);
+				putDataFill((bar > bargraph->bar) ? hBarFill(i, startPage, endPage) : barFrame(i, startPage, endPage), to-from);
+			}
+		}
+	}
+	else									// vertical: only the pages whose byte changed
+	{
+		for(i=startPage;i<=endPage;i++)
+		{
+			oldByte = vBarByte(i, startPage, endPage, bargraph->bar, height);
+			newByte = vBarByte(i, startPage, endPage, bar, height);
+			if (oldByte != newByte)
 			{
-				writeData(0x80);
-				if (bar >= 6)
-				{
-					dummy = 0;
-				}
-				else
-				{
-					dummy = 6-bar;
-				}
-				dummy = (0xFF<<dummy) & 0xBF;
-				for(j=2;j<(totalCol-2);j++)
-				{
-					writeData(dummy);
-				}
-				writeData(0x80);
-			} 
-			else
+				gotoPos(i, bargraph->startCol+2);
+				putDataFill(newByte, totalCol-4);
+			}
+		}
+	}
+	bargraph->bar = bar;
+}
+
+void ssd1309_readout_init(ssd1309_readout_t *readout, UINT8 page, UINT8 startColumn, UINT8 width, UINT8 font)
+{
+	readout->page = page;
+	readout->startColumn = startColumn;
+	readout->width = (width > SSD1309_READOUT_LEN) ? SSD1309_READOUT_LEN : width;
+	readout->font = font;
+	ssd1309_readout_invalidate(readout);
+}
+
+void ssd1309_readout_invalidate(ssd1309_readout_t *readout)
+{
+	memset(readout->last, 0, sizeof(readout->last));	// 0 is never rendered, every position differs
+}
+
+UINT8 ssd1309_readout_print(ssd1309_readout_t *readout, const char *aString)
+{
+	UINT8 i, pad, column;
+	UINT8 changed = 0;
+	bool inRun = false;						// small font: the display position follows the last glyph
+	unsigned char aChar;
+	UINT8 len = (UINT8)strlen(aString);
+	
+	pad = (len < readout->width) ? (readout->width - len) : 0;
+	column = readout->startColumn;
+	for (i=0; i<readout->width; i++)
+	{
+		aChar = (i < pad) ? ' ' : (unsigned char)aString[i-pad];	// right aligned, cut after width chars
+		if (aChar == (unsigned char)readout->last[i])
+		{
+			inRun = false;
+		}
+		else if (readout->font == SSD1309_READOUT_BIG)
+		{
+			ssd1309_putBigDigit(aChar, readout->page, column);
+			changed++;
+		}
+		else
+		{
+			if (!inRun)
 			{
-				writeData(0x00);
-				dummy = (endPage - i) * 8 + 6;
-				if (bar >= dummy)
-				{
-					dummy = 0;
-				}
-				else if ((bar + 8) <= dummy)
-				{
-					dummy = 8;
-				}
-				else
-				{
-					dummy = dummy - bar;
-				}
-				dummy = 0xFF<<dummy;
-				for(j=2;j<(totalCol-2);j++)
-				{
-					writeData(dummy);
-				}
-				writeData(0x00);
-			}	
-			writeData(0xFF);			
+				gotoPos(readout->page, column);
+				inRun = true;
+			}
+			putDataBurst((const UINT8*)font[fontIndex(aChar)], 5);
+			putData(0);
+			changed++;
 		}
-	}	
+		readout->last[i] = (char)aChar;
+		column += (readout->font == SSD1309_READOUT_BIG) ? 15 : 6;
+	}
+	return changed;
 }
 
-void ssd1309_init(void)
-{	
-	initInterface();					// Init hardware Interface
+#endif
+
+/**
+  * @brief  starts a continuous scrolling
+  *
+  * @param	*setup		the scroll setup command with its arguments, followed by 0x2F
+  * @param  len			number of bytes in setup
+  * @param  startPage	first page moved by the scrolling
+  * @param  endPage		last page moved by the scrolling
+  */
+static void scrollStart(const UINT8 *setup, UINT8 len, UINT8 startPage, UINT8 endPage)
+{
+	if (scrollActive)						// the setup must not change while scrolling
+	{
+		scrollOff();
+	}
+	writeCmdBurst(setup, len);
+	scrollActive = true;
+	scrollStartPage = startPage;
+	scrollEndPage = (endPage < SSD1309_PAGES) ? endPage : (SSD1309_PAGES-1);	// the pages the flush restores
+}
+
+void ssd1309_scroll_horizontal(UINT8 direction, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol, UINT8 interval)
+{
+	UINT8 setup[8];
+	
+	setup[0] = 0x26 + direction;			// Right / Left Horizontal Scroll Setup
+	setup[1] = 0x00;
+	setup[2] = startPage;
+	setup[3] = interval;
+	setup[4] = endPage;
+	setup[5] = startCol;
+	setup[6] = endCol;
+	setup[7] = 0x2F;						// Activate Scroll
+	scrollStart(setup, sizeof(setup), startPage, endPage);
+}
+
+void ssd1309_scroll_diagonal(UINT8 direction, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol, UINT8 interval, UINT8 verticalOffset)
+{
+	UINT8 setup[9];
+	
+	setup[0] = 0x29;						// Vertical and Right / Left Horizontal Scroll Setup
+	setup[1] = 0x01;						// horizontal scroll by one column
+	if (direction == SSD1309_SCROLL_LEFT)
+	{
+		setup[0] = 0x2A;
+	}
+	else if (direction == SSD1309_SCROLL_NONE)
+	{
+		setup[1] = 0x00;					// vertical scroll only
+	}
+	setup[2] = startPage;
+	setup[3] = interval;
+	setup[4] = endPage;
+	setup[5] = verticalOffset;
+	setup[6] = startCol;
+	setup[7] = endCol;
+	setup[8] = 0x2F;						// Activate Scroll
+	scrollStart(setup, sizeof(setup), startPage, endPage);
+}
+
+void ssd1309_scroll_area(UINT8 fixedRows, UINT8 scrollRows)
+{
+	UINT8 setup[3];
+	
+	if (scrollActive)
+	{
+		scrollOff();
+	}
+	setup[0] = 0xA3;						// Set Vertical Scroll Area
+	setup[1] = fixedRows;
+	setup[2] = scrollRows;
+	writeCmdBurst(setup, sizeof(setup));
+}
+
+void ssd1309_scroll_step(UINT8 direction, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol)
+{
+	UINT8 setup[8];
+#ifdef SSD1309_FRAMEBUFFER
+	UINT8 page, edge;
 	
-	cmd_DisplayOn(false);				// Display Off
-	cmd_DisplayClock(0xF0);				// Set Clock as 80 Frames/Sec
-	cmd_MultiplexRatio(SSD1309_ROW);	// 1/64 Duty (16-64)
-	cmd_DisplayOffset(0);				// Shift Mapping RAM Counter (0~63)
-	cmd_StartLine(0);					// Set Mapping RAM Display Start Line (0~63)
+	ssd1309_flush();						// framebuffer and GDDRAM are equal now and move together
+	for(page=startPage;page<=endPage;page++)
+	{
+		if (direction == SSD1309_SCROLL_LEFT)
+		{
+			edge = framebuffer[page][startCol];
+			memmove(&framebuffer[page][startCol], &framebuffer[page][startCol+1], endCol-startCol);
+			framebuffer[page][endCol] = edge;
+		}
+		else
+		{
+			edge = framebuffer[page][endCol];
+			memmove(&framebuffer[page][startCol+1], &framebuffer[page][startCol], endCol-startCol);
+			framebuffer[page][startCol] = edge;
+		}
+	}
+#else
+	if (scrollActive)
+	{
+		scrollOff();
+	}
+#endif
+	setup[0] = 0x2C + direction;			// Right / Left Horizontal Scroll by one column
+	setup[1] = 0x00;
+	setup[2] = startPage;
+	setup[3] = 0x01;
+	setup[4] = endPage;
+	setup[5] = 0x00;
+	setup[6] = startCol;
+	setup[7] = endCol;
+	writeCmdBurst(setup, sizeof(setup));
+}
+
+void ssd1309_scroll_stop(void)
+{
+	if (scrollActive)
+	{
+		scrollOff();
+	}
+}
+
+#if SSD1309_PANELS > 1
+
+/**
+  * @brief  stores the driver state of the selected panel in its handle
+  */
+static void panelSave(ssd1309_panel_t *panel)
+{
+	panel->addrMode = addrMode;
+	panel->scrollActive = scrollActive;
+	panel->scrollStartPage = scrollStartPage;
+	panel->scrollEndPage = scrollEndPage;
+#ifndef SSD1309_STRIP
+	panel->consoleTop = consoleTop;
+	panel->consoleLine = consoleLine;
+	panel->consoleCol = consoleCol;
+	panel->consoleEnd = consoleEnd;
+#endif
+#ifdef SSD1309_FRAMEBUFFER
+	memcpy(panel->dirtyMin, dirtyMin, sizeof(dirtyMin));
+	memcpy(panel->dirtyMax, dirtyMax, sizeof(dirtyMax));
+	memcpy(panel->flushMin, flushMin, sizeof(flushMin));
+	memcpy(panel->flushMax, flushMax, sizeof(flushMax));
+	panel->flushPage = flushPage;
+	panel->flushCol = flushCol;
+	panel->flushLast = flushLast;
+	panel->flushOpen = flushOpen;
+#endif
+}
+
+/**
+  * @brief  makes the state stored in a panel handle the driver state
+  */
+static void panelLoad(ssd1309_panel_t *panel)
+{
+	addrMode = panel->addrMode;
+	scrollActive = panel->scrollActive;
+	scrollStartPage = panel->scrollStartPage;
+	scrollEndPage = panel->scrollEndPage;
+#ifndef SSD1309_STRIP
+	consoleTop = panel->consoleTop;
+	consoleLine = panel->consoleLine;
+	consoleCol = panel->consoleCol;
+	consoleEnd = panel->consoleEnd;
+	consoleSynced = false;
+#endif
+#ifdef SSD1309_FRAMEBUFFER
+	framebuffer = (UINT8 (*)[SSD1309_COL])panel->framebuffer;
+	memcpy(dirtyMin, panel->dirtyMin, sizeof(dirtyMin));
+	memcpy(dirtyMax, panel->dirtyMax, sizeof(dirtyMax));
+	memcpy(flushMin, panel->flushMin, sizeof(flushMin));
+	memcpy(flushMax, panel->flushMax, sizeof(flushMax));
+	flushPage = panel->flushPage;
+	flushCol = panel->flushCol;
+	flushLast = panel->flushLast;
+	flushOpen = panel->flushOpen;
+#endif
+}
+
+void ssd1309_panel_init(ssd1309_panel_t *panel, UINT8 cs, UINT8 *framebuffer)
+{
+	panel->cs = cs;
+	panel->addrMode = 2;					// the state after a reset
+	panel->scrollActive = false;
+#ifndef SSD1309_STRIP
+	panel->consoleTop = 0;
+	panel->consoleLine = 0;
+	panel->consoleCol = 0;
+	panel->consoleEnd = 0;
+#endif
+#ifdef SSD1309_FRAMEBUFFER
+	panel->framebuffer = (framebuffer != NULL) ? framebuffer : &fbMemory[0][0];
+	memset(panel->dirtyMin, SSD1309_COL, sizeof(panel->dirtyMin));
+	memset(panel->dirtyMax, 0, sizeof(panel->dirtyMax));
+	memset(panel->flushMin, SSD1309_COL, sizeof(panel->flushMin));
+	memset(panel->flushMax, 0, sizeof(panel->flushMax));
+	panel->flushPage = SSD1309_PAGES;
+	panel->flushOpen = false;
+#else
+	(void)framebuffer;
+#endif
+}
+
+void ssd1309_panel_select(ssd1309_panel_t *panel)
+{
+	if (panel == selected)
+	{
+		return;
+	}
+	panelSave(selected);
+	panelLoad(panel);
+	selected = panel;
+	ssd1309_bus_select(panel->cs);
+}
+
+#endif
+
+#ifdef SSD1309_CANVAS
+
+void ssd1309_canvas_draw(ssd1309_panel_t *const *panels, UINT8 count, void (*draw)(void))
+{
+	UINT8 i;
+
+	for(i=0;i<count;i++)
+	{
+		ssd1309_panel_select(panels[i]);
+		originX = i*SSD1309_COL;
+		draw();
+	}
+	originX = 0;
+}
+
+void ssd1309_canvas_flush(ssd1309_panel_t *const *panels, UINT8 count, UINT16 maxBytes)
+{
+	UINT8 i, busy;
+
+	if (maxBytes == 0)						// a step of 0 bytes never finishes
+	{
+		maxBytes = 0xFFFF;
+	}
+	for(i=0;i<count;i++)
+	{
+		ssd1309_panel_select(panels[i]);
+		ssd1309_flush_begin();
+	}
+	do										// round robin, one step per panel
+	{
+		busy = 0;
+		for(i=0;i<count;i++)
+		{
+			ssd1309_panel_select(panels[i]);
+			if (!ssd1309_flush_step(maxBytes))
+			{
+				busy++;
+			}
+		}
+	} while (busy);
+}
+
+#endif
+
+/**
+  * default configuration, sent in one command transaction by ssd1309_init()
+  * the values are set with the SSD1309_INIT_* defines in SSD1309.h
+  */
+static const UINT8 initTable[] =
+{
+	0xAE,								// Display Off
+	0xD5, SSD1309_INIT_CLOCK,			// Set Display Clock Divide Ratio / Oscillator Frequency
+	0xA8, SSD1309_ROW-1,				// Set Multiplex Ratio
+	0xD3, 0x00,							// Set Display Offset
+	0x40,								// Set Display Start Line 0
+	0xA0|SSD1309_INIT_SEGREMAP,			// Set Segment Remap
+	0xC0|(SSD1309_INIT_COMREMAP<<3),	// Set COM Output Scan Direction
+	0xDA, (SSD1309_INIT_COMPINS<<4)|0x02,	// Set COM Pins Hardware Configuration
+	0x81, SSD1309_INIT_CONTRAST,		// Set Contrast Control
+	0xD9, SSD1309_INIT_PRECHARGE,		// Set Pre-Charge Period
+	0xDB, SSD1309_INIT_VCOMH,			// Set VCOMH Deselect Level
+	0xA4,								// Disable Entire Display On
+	0xA6								// Disable Inverse Display
+};
+STATIC_ASSERT(sizeof(initTable) <= 255, initTable_length);	// the length is passed as UINT8
+
+/**
+  * horizontal addressing window over the whole panel, used to clear the GDDRAM
+  * with one single fill after the reset
+  */
+static const UINT8 clearWindow[] =
+{
+	0x20, 0x00,							// Set Horizontal Addressing Mode
+	0x21, 0x00, SSD1309_COL-1,			// Set Column Address
+	0x22, 0x00, SSD1309_PAGES-1		// Set Page Address
+};
+
+// states of the non-blocking initialization
+#define INIT_IDLE		0				// ssd1309_init_begin() not called yet
+#define INIT_START		1				// interface configured, waiting for the first tick
+#define INIT_POWERUP	2				// 1ms with RES# high
+#define INIT_RESET		3				// 10ms with RES# low
+#define INIT_RELEASE	4				// 1ms after RES# released
+#define INIT_CLEAR		5				// clearing the GDDRAM, one page per poll
+#define INIT_READY		6
+
+static UINT8 initState = INIT_IDLE;
+static UINT8 initPage;					// next page to clear in INIT_CLEAR
+static UINT16 initTick;					// tick of the last state change
+static const UINT8 *initTablePtr;		// table for ssd1309_init_poll()
+static UINT8 initTableLen;
+
+/**
+  * @brief  sends the configuration table and opens the clear window
+  */
+static void initConfig(const UINT8 *table, UINT8 len)
+{
+	writeCmdBurst(table, len);			// board configuration
+	writeCmdBurst(clearWindow, sizeof(clearWindow));
+	addrMode = 0;
+	scrollActive = false;				// the reset stopped any scrolling
+}
+
+/**
+  * @brief  finishes the initialization after the GDDRAM was cleared
+  */
+static void initDone(void)
+{
+#ifdef SSD1309_FRAMEBUFFER
+	memset(framebuffer, 0x00, SSD1309_BUFFER_SIZE);	// framebuffer and GDDRAM are both blank now,
+	setClean();											// flushes stay in horizontal addressing mode
+	memset(flushMin, SSD1309_COL, sizeof(flushMin));	// no flush running
+	memset(flushMax, 0, sizeof(flushMax));
+	flushPage = SSD1309_PAGES;
+#elif !defined(SSD1309_STRIP)
 	cmd_AddressingMode(2);				// Set Page Addressing Mode
-	cmd_SegmentRemap(false);			// standard segment mapping
-	cmd_ComRemap(false);				// standard col mapping
-	cmd_ComPins(1);						// default com pins
-	cmd_ContrastControl(10);			// Set SEG Output Current //Brightness
-	cmd_PrechargePeriod(0xF1);			// Set Pre-Charge as 16 Clocks & Discharge as 1 Clocks  
-	cmd_Vcomh(55);						// Set VCOM Deselect Level //55
-	cmd_EntireDisplayON(false);			// Disable Entire Display On
-	cmd_InverseDisplay(false);			// Disable Inverse Display
-    ssd1309_clear();					// Clear Screen
-    cmd_DisplayOn(true);				// Display On
+#endif
+	cmd_DisplayOn(true);				// Display On
+	initState = INIT_READY;
+}
+
+void ssd1309_initWith(const UINT8 *table, UINT8 len)
+{
+	initInterface();					// Init hardware Interface
+	initConfig(table, len);
+	writeDataFill(0x00, SSD1309_BUFFER_SIZE);	// Clear Screen
+	initDone();
+}
+
+void ssd1309_init(void)
+{
+	ssd1309_initWith(initTable, sizeof(initTable));
+}
+
+void ssd1309_init_beginWith(const UINT8 *table, UINT8 len)
+{
+	initTablePtr = table;
+	initTableLen = len;
+	ssd1309_bus_init();					// OLED_RES=1
+	initState = INIT_START;
+}
+
+void ssd1309_init_begin(void)
+{
+	ssd1309_init_beginWith(initTable, sizeof(initTable));
+}
+
+bool ssd1309_init_poll(UINT16 tick)
+{
+	UINT16 elapsed = tick - initTick;	// wraps correctly
+
+	// a wait of n ms needs more than n ticks, the first tick may come right after the state change
+	switch (initState)
+	{
+		case INIT_START:
+			initTick = tick;
+			initState = INIT_POWERUP;
+#if SSD1309_PANELS > 1
+			if (selected->cs != 0)				// RES# is shared, only the first panel pulses it
+			{
+				initState = INIT_RELEASE;
+			}
+#endif
+			break;
+		case INIT_POWERUP:
+			if (elapsed > 1)
+			{
+				ssd1309_bus_reset(true);		// OLED_RES=0
+				initTick = tick;
+				initState = INIT_RESET;
+			}
+			break;
+		case INIT_RESET:
+			if (elapsed > 10)
+			{
+				ssd1309_bus_reset(false);		// OLED_RES=1
+				initTick = tick;
+				initState = INIT_RELEASE;
+			}
+			break;
+		case INIT_RELEASE:
+			if (elapsed > 1)
+			{
+				initConfig(initTablePtr, initTableLen);
+				initPage = 0;
+				initState = INIT_CLEAR;
+			}
+			break;
+		case INIT_CLEAR:
+			writeDataFill(0x00, SSD1309_COL);	// the window continues with the next page
+			if (++initPage >= SSD1309_PAGES)
+			{
+				initDone();
+			}
+			break;
+		default:
+			break;
+	}
+	return (initState == INIT_READY);
 }
 
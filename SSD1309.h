@@ -17,9 +17,27 @@
 ########################## select your interface here #########################
 #############################################################################*/
 
-//#define SSD1309_68XX		// 68XX 8-Bit interface, not implemented yet
-//#define SSD1309_80XX		// 80XX 8-Bit interface, not implemented yet
-#define	SSD1309_SPI			// SPI (5-Wire) interface, not tested
+//#define SSD1309_68XX		// 68XX 8-Bit interface, bit-banged on PORTA/PORTD (SSD1309_68XX.c)
+#define SSD1309_80XX		// 80XX 8-Bit interface, bit-banged on PORTA/PORTD (SSD1309_80XX.c)
+//#define SSD1309_SPI		// SPI (4-Wire) interface on the MSSP (SSD1309_SPI.c)
+//#define SSD1309_I2C		// I2C interface on the MSSP (SSD1309_I2C.c)
+//#define SSD1309_SIM		// host-side GDDRAM simulator for Linux builds (SSD1309_sim.c)
+
+#ifdef SSD1309_SIM				// the simulator replaces any hardware interface, e.g. gcc -DSSD1309_SIM
+#undef SSD1309_68XX
+#undef SSD1309_80XX
+#undef SSD1309_SPI
+#undef SSD1309_I2C
+#include <stdint.h>
+#include <stdbool.h>
+typedef uint8_t		UINT8;
+typedef uint16_t	UINT16;
+typedef uint32_t	UINT32;
+#endif
+
+#if (defined(SSD1309_68XX) + defined(SSD1309_80XX) + defined(SSD1309_SPI) + defined(SSD1309_I2C)) > 1
+#error "select only one SSD1309 interface"
+#endif
 
 
 /*#############################################################################
@@ -28,7 +46,9 @@
 
 #ifdef SSD1309_68XX
 
-// TODO
+// data bus on PORTD, control lines on PORTA, see SSD1309_68XX.c
+// with SSD1309_PANELS > 1 the CS# line of panel n is bit 4+n of PORTA, at most 2 panels
+// (RA6/RA7 are the oscillator pins with OSC = HS/HSPLL)
 
 #endif
 
@@ -39,7 +59,9 @@
 
 #ifdef SSD1309_80XX
 
-// TODO
+// data bus on PORTD, control lines on PORTA, see SSD1309_80XX.c
+// with SSD1309_PANELS > 1 the CS# line of panel n is bit 4+n of PORTA, at most 2 panels
+// (RA6/RA7 are the oscillator pins with OSC = HS/HSPLL)
 
 #endif
 
@@ -50,16 +72,51 @@
 
 #ifdef SSD1309_SPI
 
-#define SSD1309_PORT	PORTC_OUT	// The used PORT
-#define SSD1309_DIR		PORTC_DIR	// The corresponding DDR Register
+// MSSP as SPI master: SCK on RC3, SDO on RC5, see SSD1309_SPI.c
+#define SSD1309_SPI_LAT		LATC		// latch of the control lines
+#define SSD1309_SPI_TRIS	TRISC		// the corresponding TRIS register
+
+#define SSD1309_CS			0			// Chip Select (CS#)
+#define SSD1309_CS1			6			// CS# of the second panel, with SSD1309_PANELS > 1
+#define SSD1309_CS2			7			// CS# of the third panel, with SSD1309_PANELS > 2
+#define SSD1309_DC			1			// Data/Command (D/C#)
+#define SSD1309_RES			2			// Reset (RES#)
+
+#ifndef SSD1309_SPI_CLOCK
+#define SSD1309_SPI_CLOCK	0			// SCK = 0: Fosc/4, 1: Fosc/16, 2: Fosc/64, the SSD1309 allows up to 10 MHz
+#endif
+
+#endif
+
+
+/*#############################################################################
+######################### config I2C here, if chosen ##########################
+#############################################################################*/
+
+#ifdef SSD1309_I2C
+
+// MSSP as I2C master: SCL on RC3, SDA on RC4, see SSD1309_I2C.c
+#define SSD1309_I2C_LAT		LATC		// latch of the reset line
+#define SSD1309_I2C_TRIS	TRISC		// the corresponding TRIS register
+
+#define SSD1309_RES			2			// Reset (RES#)
+
+#endif
 
-#define SSD1309_SPI_I	SPIC		// the used SPI port
+#if defined(SSD1309_I2C) || defined(SSD1309_SIM_I2C)	// the simulator counts the I2C timing with SSD1309_SIM_I2C
 
-#define SSD1309_CS		4			// Serial Data Out (TXD)
-#define SSD1309_DC		0			// Serial Clock Out (XCK)
-#define SSD1309_RES		1			// Latch Signal (GPIO)
-#define SSD1309_SCK		7			// Serial Clock
-#define SSD1309_MOSI	5			// Master Out Display In
+#ifndef SSD1309_I2C_ADDR
+#define SSD1309_I2C_ADDR	0x3C		// 7 bit slave address, 0x3D with SA0 high, panel n uses this + n
+#endif
+#ifndef SSD1309_I2C_SSPADD
+#define SSD1309_I2C_SSPADD	24			// SCL = Fosc/(4*(SSPADD+1)), 24 = 400 kHz at 40 MHz
+#endif
+#ifndef SSD1309_I2C_CHUNK
+#define SSD1309_I2C_CHUNK	128			// maximum bytes per transaction (1-255), longer bursts are split
+#endif
+#if (SSD1309_I2C_CHUNK < 1) || (SSD1309_I2C_CHUNK > 255)
+#error "SSD1309_I2C_CHUNK must be 1-255"
+#endif
 
 #endif
 
@@ -68,14 +125,105 @@
 ############################# select display size #############################
 #############################################################################*/
 
-#define SSD1309_COL		128			
-#define SSD1309_ROW		64
+#ifndef SSD1309_COL
+#define SSD1309_COL		128			// columns of the panel (1-128)
+#endif
+#ifndef SSD1309_ROW
+#define SSD1309_ROW		64			// rows of the panel (16-64, a multiple of 8), e.g. -DSSD1309_ROW=32 for 128x32
+#endif
+
+#if (SSD1309_COL < 1) || (SSD1309_COL > 128)
+#error "SSD1309_COL must be 1-128"
+#endif
+#if (SSD1309_ROW < 16) || (SSD1309_ROW > 64) || (SSD1309_ROW % 8)
+#error "SSD1309_ROW must be 16-64 and a multiple of 8"
+#endif
+
+#define SSD1309_PAGES		(SSD1309_ROW/8)					// GDDRAM pages the panel shows
+#define SSD1309_BUFFER_SIZE	(SSD1309_COL*SSD1309_PAGES)		// bytes of a full frame
+
+
+/*#############################################################################
+######################### several panels on one bus ###########################
+#############################################################################*/
+
+#ifndef SSD1309_PANELS
+#define SSD1309_PANELS		1		// panels sharing the bus, each with its own CS# line (I2C: own
+									// address) and the same geometry, see ssd1309_panel_select()
+#endif
+
+
+/*#############################################################################
+######################## initialization, board specific #######################
+#############################################################################*/
+
+#ifndef SSD1309_INIT_CLOCK
+#define SSD1309_INIT_CLOCK		0xF0	// display clock divide ratio / oscillator frequency, 80 frames/sec
+#endif
+#ifndef SSD1309_INIT_PRECHARGE
+#define SSD1309_INIT_PRECHARGE	0xF1	// pre-charge as 15 clocks and discharge as 1 clock
+#endif
+#ifndef SSD1309_INIT_VCOMH
+#define SSD1309_INIT_VCOMH		55		// VCOMH deselect level
+#endif
+#ifndef SSD1309_INIT_CONTRAST
+#define SSD1309_INIT_CONTRAST	10		// SEG output current (brightness)
+#endif
+#ifndef SSD1309_INIT_SEGREMAP
+#define SSD1309_INIT_SEGREMAP	0		// 1 = column address 0 mapped to SEG127
+#endif
+#ifndef SSD1309_INIT_COMREMAP
+#define SSD1309_INIT_COMREMAP	0		// 1 = scan from COM63 to COM0
+#endif
+#ifndef SSD1309_INIT_COMPINS
+#if SSD1309_ROW > 32
+#define SSD1309_INIT_COMPINS	1		// COM pins hardware configuration (0-3), see cmd_ComPins()
+#else
+#define SSD1309_INIT_COMPINS	0		// sequential COM pins, the wiring of 128x32 modules
+#endif
+#endif
+
+#if (SSD1309_INIT_COMPINS < 0) || (SSD1309_INIT_COMPINS > 3)
+#error "SSD1309_INIT_COMPINS must be 0-3"
+#endif
+
+
+/*#############################################################################
+############################# optional framebuffer ############################
+#############################################################################*/
+
+//#define SSD1309_FRAMEBUFFER		// draw into a RAM framebuffer of SSD1309_BUFFER_SIZE bytes
+									// (1024 bytes for 128x64), send it with ssd1309_flush()
+
+//#define SSD1309_STRIP				// draw into a strip of SSD1309_STRIP_PAGES pages (SSD1309_COL bytes each),
+									// the frame is rendered strip by strip with ssd1309_renderStrips()
+#ifndef SSD1309_STRIP_PAGES
+#define SSD1309_STRIP_PAGES		1
+#endif
+#if (SSD1309_STRIP_PAGES < 1) || (SSD1309_STRIP_PAGES > SSD1309_PAGES)
+#error "SSD1309_STRIP_PAGES must be 1 to SSD1309_PAGES"
+#endif
+
+#if defined(SSD1309_FRAMEBUFFER) && defined(SSD1309_STRIP)
+#error "SSD1309_FRAMEBUFFER and SSD1309_STRIP can not be used together"
+#endif
+
+#if defined(SSD1309_FRAMEBUFFER) || defined(SSD1309_STRIP)
+#define SSD1309_BUFFERED			// the drawing functions write into a RAM buffer
+#endif
+
+#if defined(SSD1309_FRAMEBUFFER) && (SSD1309_PANELS > 1)
+#define SSD1309_CANVAS				// panels side by side can be drawn as one canvas, see ssd1309_canvas_draw()
+#endif
 
 
 /*#############################################################################
 ########################### function prototypes ###############################
 #############################################################################*/
 
+#define SSD1309_BLACK	0			// pixel off
+#define SSD1309_WHITE	1			// pixel on
+
 /**
   * @brief  initialize the display
   *			This function will configure the SPI-Interface and initialize and clean the display.
@@ -83,11 +231,284 @@
   */
 void ssd1309_init(void);
 
+/**
+  * @brief  initialize the display with a board specific command table
+  *
+  *			Like ssd1309_init(), but the configuration commands are taken from the table.
+  *			The table is sent in one command transaction after the reset, then the display
+  *			is cleared and turned on. Start with a copy of the default table in SSD1309.c.
+  *
+  * @param	*table	command bytes including their arguments, may be in program memory
+  * @param  len		number of bytes in the table
+  */
+void ssd1309_initWith(const UINT8 *table, UINT8 len);
+
+/**
+  * @brief  starts the non-blocking initialization of the display
+  *
+  *			Same sequence as ssd1309_init(), but nothing waits: the reset and power-up timing
+  *			is driven by ssd1309_init_poll(). No other display function may be called before
+  *			ssd1309_init_poll() returned true.
+  */
+void ssd1309_init_begin(void);
+
+/**
+  * @brief  starts the non-blocking initialization with a board specific command table
+  *
+  * @param	*table	command bytes including their arguments, see ssd1309_initWith()
+  * @param  len		number of bytes in the table
+  */
+void ssd1309_init_beginWith(const UINT8 *table, UINT8 len);
+
+/**
+  * @brief  advances the non-blocking initialization
+  *
+  *			Call it from the main loop with a free running millisecond counter. Each call
+  *			returns quickly, at most one page (SSD1309_COL bytes) is written per call.
+  *			The reset cycle takes about 14 ms, the clear SSD1309_PAGES more calls.
+  *
+  * @param	tick	millisecond counter, may wrap around
+  * @return	true when the display is initialized and on
+  */
+bool ssd1309_init_poll(UINT16 tick);
+
 /**
   * @brief  clears the whole display by writing 0x00 to memory
   */
 void ssd1309_clear(void);
 
+#ifdef SSD1309_FRAMEBUFFER
+
+/**
+  * @brief  returns the RAM framebuffer
+  *
+  *			The buffer is page-major like the GDDRAM: SSD1309_PAGES pages of SSD1309_COL bytes,
+  *			bit 0 of each byte is the top pixel of the page. All drawing functions write into
+  *			this buffer, nothing is sent to the display until ssd1309_flush() is called.
+  */
+UINT8* ssd1309_getFramebuffer(void);
+
+/**
+  * @brief  marks a column span of a page as changed
+  *
+  *			Only needed after writing into the buffer returned by ssd1309_getFramebuffer(),
+  *			the drawing functions track their changes themselves.
+  *
+  * @param  page		the page (0-7)
+  * @param  startCol	first changed column
+  * @param  endCol		last changed column, >= startCol
+  */
+void ssd1309_markDirty(UINT8 page, UINT8 startCol, UINT8 endCol);
+
+/**
+  * @brief  returns the number of bus bytes the next ssd1309_flush() will send
+  *
+  *			Command and data bytes are counted, 0 means the display is up to date. The
+  *			spans a running ssd1309_flush_step() sequence has not sent yet are included.
+  */
+UINT16 ssd1309_flushBytes(void);
+
+/**
+  * @brief  sends the changed parts of the framebuffer to the display
+  *
+  *			Each page keeps a dirty [minCol,maxCol] span of the bytes that really changed.
+  *			Uses the horizontal addressing mode, each span costs one column/page window
+  *			(6 command bytes) and one stream of its data bytes. Following pages with the
+  *			same span share one window, so a full frame is one single stream.
+  */
+void ssd1309_flush(void);
+
+/**
+  * @brief  starts sending the changed parts of the framebuffer in steps
+  *
+  *			Takes over the dirty spans like ssd1309_flush(), they are sent by the following
+  *			ssd1309_flush_step() calls. Spans of a running flush that were not sent yet are
+  *			kept and sent again from the start.
+  */
+void ssd1309_flush_begin(void);
+
+/**
+  * @brief  sends the next part of a flush started by ssd1309_flush_begin()
+  *
+  *			Resumes at the page and column where the last step stopped, so the main loop can
+  *			spread a frame over several ticks. Each step sends at most maxBytes data bytes plus
+  *			6 command bytes per window it opens, about 13 Tcy per data byte on the 8080 bus.
+  *			Drawing before the frame is complete can tear it: the pages not sent yet already
+  *			show the new content. The changes are sent by the next flush in any case.
+  *
+  * @param	maxBytes	the budget of data bytes for this step, 0 only returns the status
+  *
+  * @return	true = the frame is complete, false = more steps are needed
+  */
+bool ssd1309_flush_step(UINT16 maxBytes);
+
+#endif
+
+#ifdef SSD1309_STRIP
+
+/**
+  * @brief  renders a complete frame strip by strip
+  *
+  *			The draw function is called once per strip of SSD1309_STRIP_PAGES pages. It draws
+  *			the whole frame with the normal drawing functions, the strip buffer keeps only the
+  *			bytes of the pages of the current strip and drops everything else. Each strip starts
+  *			black and is sent to the display after the draw function returns, so overlapping
+  *			elements are composed in RAM. All strips are streamed through one window.
+  *
+  *			The draw function can skip elements that do not touch startPage..endPage. The
+  *			drawing functions have no effect outside of it.
+  *
+  *			The console, the readout fields, the incremental bar graphs and the animations
+  *			keep what is on the display between calls and are not available with strips.
+  *			Use ssd1309_print() and ssd1309_drawBargraph() in the draw function instead.
+  *
+  * @param	*draw	the draw function, called with the first and last page of the strip
+  */
+void ssd1309_renderStrips(void (*draw)(UINT8 startPage, UINT8 endPage));
+
+#endif
+
+/**
+  * @brief  fills a rectangle with one color
+  *
+  *			The rectangle is clipped at the panel edges. Without framebuffer the area is
+  *			written through one horizontal addressing mode window with one single fill, the
+  *			pixels outside of the rectangle in its top and bottom page are cleared then,
+  *			because the display can't be read back. With framebuffer they are kept.
+  *
+  * @param	x		left column of the rectangle
+  * @param  y		top row of the rectangle, may be any row (0-63)
+  * @param  w		width in pixels
+  * @param  h		height in pixels
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_fillRect(UINT8 x, UINT8 y, UINT8 w, UINT8 h, UINT8 color);
+
+/**
+  * @brief  clears a rectangle, same as ssd1309_fillRect() with SSD1309_BLACK
+  *
+  * @param	x		left column of the rectangle
+  * @param  y		top row of the rectangle
+  * @param  w		width in pixels
+  * @param  h		height in pixels
+  */
+void ssd1309_clearRect(UINT8 x, UINT8 y, UINT8 w, UINT8 h);
+
+#ifdef SSD1309_BUFFERED
+
+/*
+ * The pixel primitives need the framebuffer or the strip buffer, they change single bits.
+ * Everything is clipped at the panel edges. Horizontal runs change one bit per column
+ * with the same mask, vertical runs use one mask per page and set whole inner bytes.
+ */
+
+/**
+  * @brief  sets or clears one pixel
+  *
+  * @param	x		column
+  * @param  y		row
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_drawPixel(int x, UINT8 y, UINT8 color);
+
+/**
+  * @brief  draws a horizontal line
+  *
+  * @param	x		left column
+  * @param  y		row
+  * @param  w		length in pixels
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_drawHLine(int x, UINT8 y, UINT8 w, UINT8 color);
+
+/**
+  * @brief  draws a vertical line
+  *
+  * @param	x		column
+  * @param  y		top row
+  * @param  h		length in pixels
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_drawVLine(int x, UINT8 y, UINT8 h, UINT8 color);
+
+/**
+  * @brief  draws a line between two points (Bresenham)
+  *
+  *			Flat lines are drawn as one horizontal run per row, steep lines as one
+  *			vertical run per column.
+  *
+  * @param	x0, y0	first point
+  * @param  x1, y1	second point
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_drawLine(int x0, UINT8 y0, int x1, UINT8 y1, UINT8 color);
+
+/**
+  * @brief  draws the outline of a rectangle
+  *
+  * @param	x		left column
+  * @param  y		top row
+  * @param  w		width in pixels
+  * @param  h		height in pixels
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_drawRect(int x, UINT8 y, UINT8 w, UINT8 h, UINT8 color);
+
+/**
+  * @brief  draws the outline of a rectangle with rounded corners
+  *
+  * @param	x		left column
+  * @param  y		top row
+  * @param  w		width in pixels
+  * @param  h		height in pixels
+  * @param  r		corner radius, limited to half of the smaller side
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_drawRoundRect(int x, UINT8 y, UINT8 w, UINT8 h, UINT8 r, UINT8 color);
+
+/**
+  * @brief  draws the outline of a circle
+  *
+  * @param	cx, cy	center
+  * @param  r		radius
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_drawCircle(int cx, UINT8 cy, UINT8 r, UINT8 color);
+
+/**
+  * @brief  fills a circle, one vertical run per column
+  *
+  * @param	cx, cy	center
+  * @param  r		radius
+  * @param  color	SSD1309_WHITE or SSD1309_BLACK
+  */
+void ssd1309_fillCircle(int cx, UINT8 cy, UINT8 r, UINT8 color);
+
+#define SSD1309_ROP_COPY		0	// the source replaces the destination
+#define SSD1309_ROP_OR			1	// set source pixels are set
+#define SSD1309_ROP_AND			2	// black source pixels are cleared
+#define SSD1309_ROP_XOR			3	// set source pixels invert the destination
+#define SSD1309_ROP_TRANSPARENT	SSD1309_ROP_OR	// black source pixels are see-through
+
+/**
+  * @brief  combines a bitmap with the display content at any pixel position
+  *
+  *			The bitmap has the layout of ssd1309_showPic(): (srcH+7)/8 pages of srcW bytes,
+  *			bit 0 is the top pixel. For y%8 != 0 each source byte is shifted across two
+  *			destination pages. Only the srcW x srcH pixels are touched, the bitmap is clipped
+  *			at the right and the bottom edge. An aligned copy (y%8 == 0) is a plain byte copy.
+  *
+  * @param	*src	the bitmap, may point to program memory
+  * @param  srcW	width of the bitmap in pixels
+  * @param  srcH	height of the bitmap in pixels
+  * @param  x		destination column
+  * @param  y		destination row
+  * @param  rop		one of the SSD1309_ROP_* operations
+  */
+void ssd1309_blit(const UINT8 *src, UINT8 srcW, UINT8 srcH, UINT8 x, UINT8 y, UINT8 rop);
+
+#endif
+
 /**
   * @brief  puts a single 5x7 char at specified position
   *
@@ -97,6 +518,40 @@ void ssd1309_clear(void);
   */
 void ssd1309_putc(unsigned char aChar, UINT8 page, UINT8 startColumn);
 
+/**
+  * @brief  puts a single char of the proportional font at specified position
+  *
+  *			The proportional font is the 5x7 font without its empty columns, so narrow glyphs
+  *			like 'i', '.' or '!' only take 1-3 columns. No blank column is added.
+  *
+  * @param	aChar		the ASCII char to display (see font for available chars)
+  * @param  page		the page (line) where the char is displayed
+  * @param  startColumn	the column where the char starts
+  * @return	the width of the char in columns
+  */
+UINT8 ssd1309_putcProp(unsigned char aChar, UINT8 page, UINT8 startColumn);
+
+/**
+  * @brief  prints a string in the proportional font at specified position
+  *
+  *			The address is set once and all glyphs are streamed with one blank column
+  *			between them. Printing stops at the right edge of the display.
+  *
+  * @param	*aString	pointer to the string to print (0 terminated)
+  * @param  page		the page (line) where the string is displayed
+  * @param  startColumn	the column where the string starts
+  * @return	the column after the last printed glyph
+  */
+UINT8 ssd1309_printProp(const char *aString, UINT8 page, UINT8 startColumn);
+
+/**
+  * @brief  returns the width of a string in the proportional font
+  *
+  * @param	*aString	pointer to the string (0 terminated)
+  * @return	width in columns, as printed by ssd1309_printProp()
+  */
+UINT8 ssd1309_textWidthProp(const char *aString);
+
 /**
   * @brief  puts a single 13x16 digit at specified position
   *
@@ -140,19 +595,70 @@ void ssd1309_print_P(const char* aString, UINT8 page, UINT8 startColumn);
 /**
   * @brief  prints a formatted string at specified position
   *
+  * The glyphs are written straight to the display, there is no string buffer and no
+  * stdio. Supported conversions, each with optional '-' or '0' flag and field width:
+  *
+  *   %d %i		signed integer
+  *   %u		unsigned integer
+  *   %x %X		hexadecimal integer
+  *   %.Nq		signed fixed-point, the integer is printed with N decimal places (%.2q: 1234 -> 12.34)
+  *   %c %s		char and string
+  *   %%		percent sign
+  *
+  * Add 'l' (e.g. %ld) for long arguments. The text stops at the right edge of the display.
+  *
   * @param  page		the page (line) where the string is displayed
   * @param  startColumn	the column where the string starts
+  * @param	*__fmt		the format string
   */
 void ssd1309_printf(UINT8 page, UINT8 startColumn, const char* __fmt, ...);
 
 /**
   * @brief  prints a formatted string at specified position, format string in program memory
   *
+  * Same conversions as ssd1309_printf(), %s arguments are strings in RAM.
+  *
   * @param  page		the page (line) where the string is displayed
   * @param  startColumn	the column where the string starts
+  * @param	*__fmt		the PROGMEM format string
   */
 void ssd1309_printf_P(UINT8 page, UINT8 startColumn, const char* __fmt, ...);
 
+#ifndef SSD1309_STRIP
+
+/**
+  * @brief  clears the display and puts the console cursor to the first line
+  *
+  * The console uses the display start line as a ring buffer over the 8 GDDRAM pages,
+  * also on panels with less than 64 rows. A new line at the bottom moves the start line
+  * on by one page instead of redrawing the other lines, so the page numbers of all other
+  * functions are rotated once the console has scrolled. Call ssd1309_console_clear()
+  * before using them again. With SSD1309_FRAMEBUFFER and less than 64 rows the buffer
+  * has fewer pages than the ring, there the lines are moved up in the buffer instead
+  * and the page numbers stay as they are.
+  */
+void ssd1309_console_clear(void);
+
+/**
+  * @brief  writes a char at the console cursor
+  *
+  * '\n' starts a new line, '\r' goes back to the start of the line. Old text behind the
+  * cursor is cleared when the line ends with one of them. A full line wraps to the next
+  * line. With the framebuffer, call ssd1309_flush() after each new line.
+  *
+  * @param	aChar	the char to write
+  */
+void ssd1309_console_putc(char aChar);
+
+/**
+  * @brief  writes a string at the console cursor, see ssd1309_console_putc()
+  *
+  * @param	*aString	pointer to the string to write (0 terminated)
+  */
+void ssd1309_console_puts(const char *aString);
+
+#endif
+
 /**
   * @brief  shows a picture at specified position
   *         Use the Image2GLCD tool from http://www.avrportal.com/?page=image2glcd to generate
@@ -166,6 +672,108 @@ void ssd1309_printf_P(UINT8 page, UINT8 startColumn, const char* __fmt, ...);
   */
 void ssd1309_showPic(const UINT8 *pic, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol);
 
+/**
+  * @brief  shows a window of a larger picture, for panning across a map or image in flash
+  *
+  *			The picture has the layout of ssd1309_showPic() with picWidth bytes per page.
+  *			The window starts at any source pixel row. Rows that are not page aligned are
+  *			merged from two source pages while streaming, so no RAM buffer is needed.
+  *			The window is clipped at the panel edges, parts outside the picture are cleared.
+  *
+  * @param	*pic		pointer to the picture data, type have to be a "const UINT8 PROGMEM" array
+  * @param  picWidth	width of the picture, the source stride
+  * @param  picHeight	height of the picture in pixels
+  * @param  srcX		first source column of the window
+  * @param  srcY		first source row of the window, any pixel row
+  * @param  startPage	the page where the window starts on the display
+  * @param  endPage		the page where the window ends on the display
+  * @param  startCol	the column where the window starts on the display
+  * @param  endCol		the column where the window ends on the display
+  */
+void ssd1309_showPicWindow(const UINT8 *pic, UINT16 picWidth, UINT16 picHeight, UINT16 srcX, UINT16 srcY, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol);
+
+#ifndef SSD1309_STRIP
+
+/**
+  * @brief  a delta frame animation, set up with ssd1309_anim_init()
+  *
+  *			The animation data starts with the number of frames and the frame period in ms
+  *			(16 bit, low byte first), followed by the key frame in the ssd1309_showPicRLE()
+  *			format. Then there is one delta per frame: the number of spans and for each span
+  *			the page and column relative to the animation position, the length and the bytes.
+  *			The delta of the last frame leads back to the key frame, so the animation loops.
+  *			Use tools/ssd1309_anim.c to generate the data from a frame sequence.
+  *			Not available in strip mode, a delta needs the previous frame on the display.
+  */
+typedef struct
+{
+	const UINT8 *data;				// the animation data
+	const UINT8 *first;				// the delta of the first frame, behind the key frame
+	const UINT8 *next;				// the delta of the next frame
+	UINT16 period;					// frame period in ms, taken from the animation data
+	UINT8 frames;					// number of frames, key frame included
+	UINT8 frame;					// the frame on the display, 0 = key frame
+	UINT8 page;						// the page where the animation starts
+	UINT8 col;						// x offset for display position
+	UINT16 tick;					// tick the frame on the display is due, see ssd1309_anim_poll()
+	bool timed;						// tick is set
+} ssd1309_anim_t;
+
+/**
+  * @brief  sets up an animation and draws its key frame
+  *
+  * @param	*anim	the animation
+  * @param  *data	pointer to the animation data, type have to be a "const UINT8 PROGMEM" array
+  * @param  page	the page where the animation starts
+  * @param  col		x offset for display position
+  */
+void ssd1309_anim_init(ssd1309_anim_t *anim, const UINT8 *data, UINT8 page, UINT8 col);
+
+/**
+  * @brief  shows the next frame, only the spans that changed are written
+  *
+  *			Call it every anim->period ms from a timer tick, or use ssd1309_anim_poll().
+  *
+  * @param	*anim	the animation
+  * @return	the frame now on the display, 0 when the animation is back at the key frame
+  */
+UINT8 ssd1309_anim_next(ssd1309_anim_t *anim);
+
+/**
+  * @brief  plays an animation at the frame period of its data
+  *
+  *			Call it from the main loop with a free running millisecond counter, like
+  *			ssd1309_init_poll(). The first call starts the timing, later calls show the next
+  *			frame with ssd1309_anim_next() each time the period has elapsed. A late call
+  *			keeps the frame rate, a call more than one period late restarts the timing.
+  *
+  * @param	*anim	the animation
+  * @param  tick	millisecond counter, may wrap around
+  * @return	true when a new frame was shown
+  */
+bool ssd1309_anim_poll(ssd1309_anim_t *anim, UINT16 tick);
+
+#endif
+
+#define SSD1309_RLE_LITERAL	0x00	// 0x00-0x7F: 1-128 literal bytes follow
+#define SSD1309_RLE_ZEROS	0x80	// 0x80-0xBF: run of 1-64 bytes 0x00
+#define SSD1309_RLE_RUN		0xC0	// 0xC0-0xFF: run of 1-64 copies of the following byte
+
+/**
+  * @brief  shows a run length compressed picture
+  *
+  *			The stream starts with the width and the number of pages of the picture,
+  *			followed by the SSD1309_RLE_* tokens for the bytes of the ssd1309_showPic()
+  *			layout, page after page. Runs may cross page ends. Literal bytes are sent
+  *			straight from the stream and runs as fills, no RAM buffer is needed.
+  *			Use tools/ssd1309_rle.c to compress an Image2GLCD array.
+  *
+  * @param	*rle		pointer to the compressed picture, type have to be a "const UINT8 PROGMEM" array
+  * @param  startPage	the page where the picture starts
+  * @param  startCol	x offset for display position
+  */
+void ssd1309_showPicRLE(const UINT8 *rle, UINT8 startPage, UINT8 startCol);
+
 /**
   * @brief  draws a bar graph at specified position
   *
@@ -177,6 +785,323 @@ void ssd1309_showPic(const UINT8 *pic, UINT8 startPage, UINT8 endPage, UINT8 sta
   */
 void ssd1309_drawBargraph(UINT8 percent, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol);
 
+#ifndef SSD1309_STRIP
+
+/**
+  * @brief  a bar graph that only redraws the part between the old and the new filling
+  *
+  *			Same look and size limits as ssd1309_drawBargraph(), set up with ssd1309_bargraph_init().
+  */
+typedef struct
+{
+	UINT8 startPage;				// the page where the bar graph starts
+	UINT8 endPage;					// the page where the bar graph ends
+	UINT8 startCol;					// x offset for display position
+	UINT8 totalCol;					// with of the bar graph
+	UINT8 bar;						// bar length in pixels on the display, 0xFF = not drawn
+} ssd1309_bargraph_t;
+
+/**
+  * @brief  sets up a bar graph, the next ssd1309_bargraph_set() draws it completely
+  *
+  * @param	*bargraph	the bar graph
+  * @param  startPage	the page where the bar graph starts, each page is 8 pixels high
+  * @param  endPage		the page where the bar graph ends, >= startPage
+  * @param  startCol	x offset for display position
+  * @param  totalCol	with of the bar graph, with > height gives a horizontal bar graph
+  */
+void ssd1309_bargraph_init(ssd1309_bargraph_t *bargraph, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 totalCol);
+
+/**
+  * @brief  forgets the bar on the display, call it after the bar graph area was overwritten
+  *
+  * @param	*bargraph	the bar graph
+  */
+void ssd1309_bargraph_invalidate(ssd1309_bargraph_t *bargraph);
+
+/**
+  * @brief  sets the filling of a bar graph
+  *
+  * A horizontal bar graph only rewrites the columns between the old and the new bar
+  * length, a vertical bar graph only the pages whose pixels changed.
+  *
+  * @param	*bargraph	the bar graph
+  * @param	percent		the filling of the graph (0-100%)
+  */
+void ssd1309_bargraph_set(ssd1309_bargraph_t *bargraph, UINT8 percent);
+
+#ifndef SSD1309_READOUT_LEN
+#define SSD1309_READOUT_LEN		8	// maximum width of a readout field in chars
+#endif
+
+#define SSD1309_READOUT_SMALL	0	// readout in the small 5x7 font, 6 columns per char
+#define SSD1309_READOUT_BIG		1	// readout in the big 13x16 font, 15 columns and 2 pages per char
+
+/**
+  * @brief  a right aligned text field that only redraws the chars that changed
+  *
+  *			Keeps the chars shown on the display, set up with ssd1309_readout_init().
+  */
+typedef struct
+{
+	UINT8 page;						// the page (line) of the field, the upper page for the big font
+	UINT8 startColumn;				// the column where the field starts
+	UINT8 width;					// width of the field in chars
+	UINT8 font;						// SSD1309_READOUT_SMALL or SSD1309_READOUT_BIG
+	char last[SSD1309_READOUT_LEN];	// chars on the display, 0 = unknown
+} ssd1309_readout_t;
+
+/**
+  * @brief  sets up a readout field, the next ssd1309_readout_print() draws all chars
+  *
+  * @param	*readout	the readout field
+  * @param  page		the page (line) where the field is displayed, the big font needs one more page below
+  * @param  startColumn	the column where the field starts
+  * @param  width		width of the field in chars, at most SSD1309_READOUT_LEN
+  * @param  font		SSD1309_READOUT_SMALL or SSD1309_READOUT_BIG
+  */
+void ssd1309_readout_init(ssd1309_readout_t *readout, UINT8 page, UINT8 startColumn, UINT8 width, UINT8 font);
+
+/**
+  * @brief  forgets the chars on the display, call it after the field area was overwritten
+  *
+  * @param	*readout	the readout field
+  */
+void ssd1309_readout_invalidate(ssd1309_readout_t *readout);
+
+/**
+  * @brief  prints a string right aligned into a readout field
+  *
+  * Only the chars that differ from the last call are sent to the display. Shorter
+  * strings are padded with blanks on the left, longer strings are cut after width chars.
+  * The big font shows the same chars as ssd1309_print_bigDigit().
+  *
+  * @param	*readout	the readout field
+  * @param	*aString	pointer to the string to print (0 terminated)
+  *
+  * @return	number of chars that were redrawn
+  */
+UINT8 ssd1309_readout_print(ssd1309_readout_t *readout, const char *aString);
+
+#endif
+
+#define SSD1309_SCROLL_RIGHT	0	// scroll direction
+#define SSD1309_SCROLL_LEFT		1
+#define SSD1309_SCROLL_NONE		2	// ssd1309_scroll_diagonal() only: vertical scrolling only
+
+#define SSD1309_SCROLL_2FRAMES		0x07	// scroll interval, one step every n frames
+#define SSD1309_SCROLL_3FRAMES		0x04
+#define SSD1309_SCROLL_4FRAMES		0x05
+#define SSD1309_SCROLL_5FRAMES		0x00
+#define SSD1309_SCROLL_25FRAMES		0x06
+#define SSD1309_SCROLL_64FRAMES		0x01
+#define SSD1309_SCROLL_128FRAMES	0x02
+#define SSD1309_SCROLL_256FRAMES	0x03
+
+/**
+  * @brief  starts a continuous horizontal scrolling done by the display itself
+  *
+  * The scrolling costs no bus traffic until it is stopped. Any function that writes to
+  * the display stops it first, see ssd1309_scroll_stop().
+  *
+  * @param	direction	SSD1309_SCROLL_RIGHT or SSD1309_SCROLL_LEFT
+  * @param  startPage	first page of the scrolled area
+  * @param  endPage		last page of the scrolled area, >= startPage
+  * @param  startCol	first column of the scrolled area
+  * @param  endCol		last column of the scrolled area, > startCol
+  * @param  interval	one of the SSD1309_SCROLL_xFRAMES speeds
+  */
+void ssd1309_scroll_horizontal(UINT8 direction, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol, UINT8 interval);
+
+/**
+  * @brief  starts a continuous vertical and horizontal scrolling done by the display itself
+  *
+  * The rows that move vertically are set with ssd1309_scroll_area(), the horizontal
+  * movement works like ssd1309_scroll_horizontal().
+  *
+  * @param	direction		SSD1309_SCROLL_RIGHT, SSD1309_SCROLL_LEFT or SSD1309_SCROLL_NONE
+  * @param  startPage		first page of the horizontally scrolled area
+  * @param  endPage			last page of the horizontally scrolled area, >= startPage
+  * @param  startCol		first column of the horizontally scrolled area
+  * @param  endCol			last column of the horizontally scrolled area, > startCol
+  * @param  interval		one of the SSD1309_SCROLL_xFRAMES speeds
+  * @param  verticalOffset	rows moved up per scroll step (1-63)
+  */
+void ssd1309_scroll_diagonal(UINT8 direction, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol, UINT8 interval, UINT8 verticalOffset);
+
+/**
+  * @brief  sets the rows of the vertical scrolling, stops a running scrolling
+  *
+  * @param	fixedRows	number of rows at the top that do not move
+  * @param  scrollRows	number of rows below them that move, fixedRows + scrollRows <= SSD1309_ROW
+  */
+void ssd1309_scroll_area(UINT8 fixedRows, UINT8 scrollRows);
+
+/**
+  * @brief  moves the content of an area by one column, the column moved out comes in on the other side
+  *
+  * Wait at least two frames before the next step. With the framebuffer, pending
+  * changes are flushed first and the framebuffer is moved the same way.
+  *
+  * @param	direction	SSD1309_SCROLL_RIGHT or SSD1309_SCROLL_LEFT
+  * @param  startPage	first page of the area
+  * @param  endPage		last page of the area, >= startPage
+  * @param  startCol	first column of the area
+  * @param  endCol		last column of the area, > startCol
+  */
+void ssd1309_scroll_step(UINT8 direction, UINT8 startPage, UINT8 endPage, UINT8 startCol, UINT8 endCol);
+
+/**
+  * @brief  stops a continuous scrolling
+  *
+  * The scrolling has moved the display content. Without the framebuffer the scrolled
+  * area has to be redrawn, with the framebuffer the next ssd1309_flush() restores it.
+  * Functions that write to the display call it by themselves.
+  */
+void ssd1309_scroll_stop(void);
+
+#if SSD1309_PANELS > 1
+
+/**
+  * @brief  driver state of one panel, see ssd1309_panel_select()
+  *
+  * The fields belong to the driver: set them up with ssd1309_panel_init() and do not
+  * change them afterwards.
+  */
+typedef struct
+{
+	UINT8 cs;								// CS# line (I2C: address offset) of the panel, 0 = the one that pulses RES#
+	UINT8 addrMode;							// state of the panel while another one is selected
+	bool scrollActive;
+	UINT8 scrollStartPage;
+	UINT8 scrollEndPage;
+#ifndef SSD1309_STRIP
+	UINT8 consoleTop;
+	UINT8 consoleLine;
+	UINT8 consoleCol;
+	UINT8 consoleEnd;
+#endif
+#ifdef SSD1309_FRAMEBUFFER
+	UINT8 *framebuffer;						// SSD1309_BUFFER_SIZE bytes
+	UINT8 dirtyMin[SSD1309_PAGES];
+	UINT8 dirtyMax[SSD1309_PAGES];
+	UINT8 flushMin[SSD1309_PAGES];
+	UINT8 flushMax[SSD1309_PAGES];
+	UINT8 flushPage;
+	UINT8 flushCol;
+	UINT8 flushLast;
+	bool flushOpen;
+#endif
+} ssd1309_panel_t;
+
+/**
+  * @brief  sets up the state of a panel, does not talk to the display
+  *
+  * @param	*panel			the panel
+  * @param  cs				CS# line of the panel (0 to SSD1309_PANELS-1), with I2C the offset to SSD1309_I2C_ADDR
+  * @param  *framebuffer	SSD1309_BUFFER_SIZE bytes with SSD1309_FRAMEBUFFER, NULL for the built-in
+  *							buffer (give it to one panel only) or without framebuffer
+  */
+void ssd1309_panel_init(ssd1309_panel_t *panel, UINT8 cs, UINT8 *framebuffer);
+
+/**
+  * @brief  makes a panel the target of all following driver functions
+  *
+  *			The state of the panel selected before (address mode, scrolling, console,
+  *			framebuffer and flush progress) is stored in its struct. Until the first call
+  *			the driver works on cs 0 with the built-in framebuffer, so single panel code
+  *			runs unchanged; select the panels before their ssd1309_init(). All panels share
+  *			RES#: initialize the panel with cs 0 first, it resets all of them, and finish an
+  *			ssd1309_init_poll() sequence before selecting another panel.
+  *
+  * @param	*panel	a panel set up with ssd1309_panel_init()
+  */
+void ssd1309_panel_select(ssd1309_panel_t *panel);
+
+#endif
+
+#ifdef SSD1309_CANVAS
+
+/**
+  * @brief  draws on panels placed side by side as on one canvas of count*SSD1309_COL columns
+  *
+  *			draw() is called once per panel with the panel selected. The x coordinates of
+  *			the pixel, line, rectangle and circle functions are canvas columns during the
+  *			call and are clipped at the panel edges. Text and blit functions are not moved.
+  *
+  * @param	*panels	the panels from left to right
+  * @param  count	number of panels
+  * @param  draw	draws the canvas content
+  */
+void ssd1309_canvas_draw(ssd1309_panel_t *const *panels, UINT8 count, void (*draw)(void));
+
+/**
+  * @brief  flushes the framebuffers of several panels, one ssd1309_flush_step() per panel in turn
+  *
+  *			While one panel is selected the others are not waited for, so the bus does not
+  *			idle between the panels. Returns when all panels are up to date.
+  *
+  * @param	*panels	the panels
+  * @param  count	number of panels
+  * @param  maxBytes	data bytes per step and panel, see ssd1309_flush_step(),
+  *						0 flushes each panel in one step like ssd1309_flush()
+  */
+void ssd1309_canvas_flush(ssd1309_panel_t *const *panels, UINT8 count, UINT16 maxBytes);
+
+#endif
+
 void cmd_ContrastControl(UINT8 contrast);
 
+
+/*#############################################################################
+################## simulator functions, only with SSD1309_SIM #################
+#############################################################################*/
+
+#ifdef SSD1309_SIM
+
+/**
+  * @brief  bus traffic counters of the simulator
+  */
+typedef struct
+{
+	UINT32 cmdBytes;		// command bytes written, including command arguments
+	UINT32 dataBytes;		// graphic data bytes written
+	UINT32 transactions;	// bus transactions (CS# low periods)
+	UINT32 tcy;				// estimated instruction cycles spent on the bus and in delays
+	UINT32 firstPixelTcy;	// Tcy from the last reset release until the display was turned on
+	UINT32 scrollWrites;	// data bytes written while a continuous scrolling was running
+} ssd1309_simStats_t;
+
+/**
+  * @brief  sets all bus traffic counters to zero
+  */
+void ssd1309_sim_resetStats(void);
+
+/**
+  * @brief  returns the bus traffic counters since the last ssd1309_sim_resetStats()
+  */
+const ssd1309_simStats_t* ssd1309_sim_getStats(void);
+
+/**
+  * @brief  returns the raw 128x64 GDDRAM of the model, 8 pages of 128 bytes
+  */
+const UINT8* ssd1309_sim_getGddram(void);
+
+/**
+  * @brief  returns a pixel as seen on the panel
+  *
+  *			Segment remap, COM remap, start line, offset, inverse and display on/off are applied.
+  *
+  * @param	x	column on the panel (0-127)
+  * @param  y	row on the panel (0-63)
+  */
+bool ssd1309_sim_getPixel(UINT8 x, UINT8 y);
+
+/**
+  * @brief  prints the panel content as ASCII art to stdout
+  */
+void ssd1309_sim_print(void);
+
+#endif
+
 #endif /* SSD1309_H_ */
\ No newline at end of file
@@ -0,0 +1,157 @@
+/**
+ * @file	SSD1309_80XX.c
+ * @brief	8080 8-Bit parallel bus backend of the SSD1309 OLED Driver library.
+ *
+ * Bit-banged on two ports: the data bus D0-D7 on DATA_PORT and the control lines on
+ * CONTROL_PORT with RD# = bit 0, WR# = bit 1, D/C# = bit 2, RES# = bit 3 and CS# = bit 4.
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <xc.h>
+#include "SSD1309.h"
+
+#ifdef SSD1309_80XX
+
+#include "SSD1309_bus.h"
+
+#define CONTROL_PORT		PORTA
+#define CONTROL_PORT_CONF	TRISA
+#define DATA_PORT			PORTD
+#define DATA_PORT_CONF		TRISD
+
+#if SSD1309_PANELS > 2
+#error "CS# lines for at most 2 panels, RA4/RA5: RA6/RA7 are the oscillator pins with OSC = HS/HSPLL (config.h)"
+#endif
+
+#define CS_OFF				(((1 << SSD1309_PANELS) - 1) << 4)	// CS# of panel n is bit 4+n, all high
+
+#if SSD1309_PANELS > 1
+static UINT8 csOn = CS_OFF & ~0x10;	// CS# bits while the selected panel is addressed
+#else
+#define csOn				0x00
+#endif
+
+void ssd1309_bus_init(void)
+{
+ CONTROL_PORT_CONF=0x00;
+ DATA_PORT_CONF=0x00;
+ DATA_PORT=0x00;
+
+ CONTROL_PORT=0x0F|CS_OFF; //OLED_RES=1
+}
+
+void ssd1309_bus_reset(bool active)
+{
+	if (active)
+	{
+		CONTROL_PORT=0x07|CS_OFF; //OLED_RES=0
+	}
+	else
+	{
+		CONTROL_PORT=0x0F|CS_OFF; //OLED_RES=1
+	}
+}
+
+void ssd1309_bus_writeCmd(UINT8 command)
+{
+ DATA_PORT=command;
+ CONTROL_PORT=0x0F|CS_OFF; //OLED_DC=1
+ CONTROL_PORT=0x0B|CS_OFF; //OLED_DC=0
+ CONTROL_PORT=0x0B|csOn; //OLED_CS=0
+ CONTROL_PORT=0x09|csOn; //OLED_WR=0
+ Nop();
+ CONTROL_PORT=0x0B|csOn; //OLED_WR=1
+ CONTROL_PORT=0x0F|csOn; //OLED_DC=1
+ CONTROL_PORT=0x0F|CS_OFF; //OLED_CS=1
+}
+
+void ssd1309_bus_writeCmdBurst(const UINT8 *commands, UINT8 len)
+{
+ UINT8 strobe = 0x09|csOn;		// loop values, so the strobe costs no more than with constants
+ UINT8 hold = 0x0B|csOn;
+
+ if (len == 0)
+ {
+	return;
+ }
+ CONTROL_PORT=0x0B|CS_OFF; //OLED_DC=0
+ CONTROL_PORT=0x0B|csOn; //OLED_CS=0
+ do
+ {
+	DATA_PORT=*commands++;
+	CONTROL_PORT=strobe; //OLED_WR=0
+	Nop();
+	CONTROL_PORT=hold; //OLED_WR=1
+ } while (--len);
+ CONTROL_PORT=0x0F|csOn; //OLED_DC=1
+ CONTROL_PORT=0x0F|CS_OFF; //OLED_CS=1
+}
+
+void ssd1309_bus_writeData(UINT8 data)
+{
+ DATA_PORT=data;
+ CONTROL_PORT=0x0B|CS_OFF; //OLED_DC=0
+ CONTROL_PORT=0x0F|CS_OFF; //OLED_DC=1
+ CONTROL_PORT=0x0F|csOn; //OLED_CS=0
+ CONTROL_PORT=0x0D|csOn; //OLED_WR=0
+ Nop();
+ CONTROL_PORT=0x0F|csOn; //OLED_WR=1
+ CONTROL_PORT=0x0B|csOn; //OLED_DC=0
+ CONTROL_PORT=0x0B|CS_OFF; //OLED_CS=1
+}
+
+void ssd1309_bus_writeDataBurst(const UINT8 *data, UINT16 len)
+{
+ UINT8 strobe = 0x0D|csOn;		// loop values, so the strobe costs no more than with constants
+ UINT8 hold = 0x0F|csOn;
+
+ if (len == 0)
+ {
+	return;
+ }
+ CONTROL_PORT=0x0F|CS_OFF; //OLED_DC=1
+ CONTROL_PORT=0x0F|csOn; //OLED_CS=0
+ do
+ {
+	DATA_PORT=*data++;
+	CONTROL_PORT=strobe; //OLED_WR=0
+	Nop();
+	CONTROL_PORT=hold; //OLED_WR=1
+ } while (--len);
+ CONTROL_PORT=0x0B|csOn; //OLED_DC=0
+ CONTROL_PORT=0x0B|CS_OFF; //OLED_CS=1
+}
+
+void ssd1309_bus_writeDataFill(UINT8 value, UINT16 len)
+{
+ UINT8 strobe = 0x0D|csOn;		// loop values, so the strobe costs no more than with constants
+ UINT8 hold = 0x0F|csOn;
+
+ if (len == 0)
+ {
+	return;
+ }
+ DATA_PORT=value;
+ CONTROL_PORT=0x0F|CS_OFF; //OLED_DC=1
+ CONTROL_PORT=0x0F|csOn; //OLED_CS=0
+ do
+ {
+	CONTROL_PORT=strobe; //OLED_WR=0
+	Nop();
+	CONTROL_PORT=hold; //OLED_WR=1
+ } while (--len);
+ CONTROL_PORT=0x0B|csOn; //OLED_DC=0
+ CONTROL_PORT=0x0B|CS_OFF; //OLED_CS=1
+}
+
+#if SSD1309_PANELS > 1
+
+void ssd1309_bus_select(UINT8 panel)
+{
+ csOn = CS_OFF & ~(0x10 << panel);
+}
+
+#endif
+
+#endif /* SSD1309_80XX */
@@ -0,0 +1,208 @@
+/**
+ * @file	SSD1309_I2C.c
+ * @brief	I2C backend of the SSD1309 OLED Driver library, driven by the MSSP.
+ *
+ * The MSSP runs as I2C master, SCL on RC3 and SDA on RC4. RES# is a port pin,
+ * configured in SSD1309.h.
+ *
+ * Every transaction starts with the slave address and one control byte: 0x00 for a
+ * list of commands, 0x40 for a stream of graphic data (Co = 0, so no further control
+ * bytes follow). Bursts longer than SSD1309_I2C_CHUNK bytes are split into several
+ * transactions of at most that length. A transaction whose address or control byte
+ * is not acknowledged (no panel at SSD1309_I2C_ADDR) is ended with a stop condition
+ * and the rest of the burst is dropped.
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <xc.h>
+#include "SSD1309.h"
+
+#ifdef SSD1309_I2C
+
+#include "SSD1309_bus.h"
+
+#if SSD1309_PANELS > 2
+#error "the SSD1309 has only two I2C addresses, at most 2 panels"
+#endif
+
+#if SSD1309_PANELS > 1
+static UINT8 slaveAddr = SSD1309_I2C_ADDR << 1;	// write address of the selected panel
+#else
+#define slaveAddr	(SSD1309_I2C_ADDR << 1)
+#endif
+
+#define CONTROL_CMD		0x00		// Co = 0, D/C# = 0: command bytes follow
+#define CONTROL_DATA	0x40		// Co = 0, D/C# = 1: data bytes follow
+
+/**
+  * @brief  waits until the MSSP is idle: no start, stop, acknowledge or transmission in progress
+  */
+static void i2cIdle(void)
+{
+	while ((SSPCON2 & 0x1F) || SSPSTATbits.R_W)
+	{
+	}
+}
+
+/**
+  * @brief  sends a stop condition after the last byte
+  */
+static void i2cEnd(void)
+{
+	i2cIdle();
+	SSPCON2bits.PEN = 1;			// stop condition
+}
+
+/**
+  * @brief  sends a start condition, the slave address and the control byte
+  *
+  * @param	control	CONTROL_CMD or CONTROL_DATA
+  * @return	false if the panel did not acknowledge, the transaction is ended then
+  */
+static bool i2cBegin(UINT8 control)
+{
+	i2cIdle();
+	SSPCON2bits.SEN = 1;			// start condition
+	i2cIdle();
+	SSPBUF = slaveAddr;				// slave address, write
+	i2cIdle();
+	if (SSPCON2bits.ACKSTAT)		// no panel at this address
+	{
+		i2cEnd();
+		return false;
+	}
+	SSPBUF = control;
+	i2cIdle();
+	if (SSPCON2bits.ACKSTAT)
+	{
+		i2cEnd();
+		return false;
+	}
+	return true;
+}
+
+/**
+  * @brief  sends one byte after the previous one is out
+  */
+static void i2cWrite(UINT8 value)
+{
+	i2cIdle();
+	SSPBUF = value;
+}
+
+void ssd1309_bus_init(void)
+{
+	SSD1309_I2C_LAT |= (1 << SSD1309_RES);
+	SSD1309_I2C_TRIS &= ~(1 << SSD1309_RES);
+	TRISCbits.TRISC3 = 1;			// SCL and SDA are driven by the MSSP
+	TRISCbits.TRISC4 = 1;
+
+	SSPADD = SSD1309_I2C_SSPADD;
+	SSPSTAT = 0x00;					// slew rate control on, for 400 kHz
+	SSPCON2 = 0x00;
+	SSPCON1 = 0x28;					// SSPEN, I2C master mode, clock = Fosc/(4*(SSPADD+1))
+}
+
+void ssd1309_bus_reset(bool active)
+{
+	if (active)
+	{
+		SSD1309_I2C_LAT &= ~(1 << SSD1309_RES);
+	}
+	else
+	{
+		SSD1309_I2C_LAT |= (1 << SSD1309_RES);
+	}
+}
+
+void ssd1309_bus_writeCmd(UINT8 command)
+{
+	if (!i2cBegin(CONTROL_CMD))
+	{
+		return;
+	}
+	i2cWrite(command);
+	i2cEnd();
+}
+
+void ssd1309_bus_writeCmdBurst(const UINT8 *commands, UINT8 len)
+{
+	UINT8 n;
+
+	while (len)
+	{
+		n = (len > SSD1309_I2C_CHUNK) ? SSD1309_I2C_CHUNK : len;
+		len -= n;
+		if (!i2cBegin(CONTROL_CMD))
+		{
+			return;
+		}
+		do
+		{
+			i2cWrite(*commands++);
+		} while (--n);
+		i2cEnd();
+	}
+}
+
+void ssd1309_bus_writeData(UINT8 data)
+{
+	if (!i2cBegin(CONTROL_DATA))
+	{
+		return;
+	}
+	i2cWrite(data);
+	i2cEnd();
+}
+
+void ssd1309_bus_writeDataBurst(const UINT8 *data, UINT16 len)
+{
+	UINT8 n;
+
+	while (len)
+	{
+		n = (len > SSD1309_I2C_CHUNK) ? SSD1309_I2C_CHUNK : (UINT8)len;
+		len -= n;
+		if (!i2cBegin(CONTROL_DATA))
+		{
+			return;
+		}
+		do
+		{
+			i2cWrite(*data++);
+		} while (--n);
+		i2cEnd();
+	}
+}
+
+void ssd1309_bus_writeDataFill(UINT8 value, UINT16 len)
+{
+	UINT8 n;
+
+	while (len)
+	{
+		n = (len > SSD1309_I2C_CHUNK) ? SSD1309_I2C_CHUNK : (UINT8)len;
+		len -= n;
+		if (!i2cBegin(CONTROL_DATA))
+		{
+			return;
+		}
+		do
+		{
+			i2cWrite(value);
+		} while (--n);
+		i2cEnd();
+	}
+}
+
+#if SSD1309_PANELS > 1
+
+void ssd1309_bus_select(UINT8 panel)
+{
+	slaveAddr = (SSD1309_I2C_ADDR + panel) << 1;
+}
+
+#endif
+
+#endif /* SSD1309_I2C */
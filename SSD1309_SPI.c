@@ -0,0 +1,164 @@
+/**
+ * @file	SSD1309_SPI.c
+ * @brief	4-wire SPI backend of the SSD1309 OLED Driver library, driven by the MSSP.
+ *
+ * The MSSP runs as SPI master, mode 0 (CKP = 0, CKE = 1), SCK on RC3 and SDO on RC5.
+ * CS#, D/C# and RES# are port pins, configured in SSD1309.h.
+ *
+ * The MSSP has a single buffer: SSPBUF can not be written while a byte is shifting
+ * (write collision). The burst loops therefore fetch the next byte and count the loop
+ * while the current byte shifts out, and write SSPBUF as soon as BF signals the end of
+ * the transfer. D/C# and CS# are set once per burst.
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <xc.h>
+#include "SSD1309.h"
+
+#ifdef SSD1309_SPI
+
+#include "SSD1309_bus.h"
+
+#if SSD1309_PANELS > 3
+#error "CS# lines for at most 3 panels, SSD1309_CS, SSD1309_CS1 and SSD1309_CS2"
+#elif SSD1309_PANELS > 2
+#define CS_ALL		((1 << SSD1309_CS) | (1 << SSD1309_CS1) | (1 << SSD1309_CS2))
+#elif SSD1309_PANELS > 1
+#define CS_ALL		((1 << SSD1309_CS) | (1 << SSD1309_CS1))
+#else
+#define CS_ALL		(1 << SSD1309_CS)
+#endif
+
+#if SSD1309_PANELS > 1
+static UINT8 csMask = 1 << SSD1309_CS;	// CS# of the selected panel
+#define CS_LOW()	(SSD1309_SPI_LAT &= ~csMask)
+#else
+#define CS_LOW()	(SSD1309_SPI_LAT &= ~(1 << SSD1309_CS))
+#endif
+#define CS_HIGH()	(SSD1309_SPI_LAT |= CS_ALL)
+#define DC_CMD()	(SSD1309_SPI_LAT &= ~(1 << SSD1309_DC))
+#define DC_DATA()	(SSD1309_SPI_LAT |= (1 << SSD1309_DC))
+
+#define SPI_WAIT()	do { while (!SSPSTATbits.BF); (void)SSPBUF; } while (0)	// end of the transfer, reading SSPBUF clears BF
+
+void ssd1309_bus_init(void)
+{
+	SSD1309_SPI_LAT |= CS_ALL | (1 << SSD1309_DC) | (1 << SSD1309_RES);
+	SSD1309_SPI_TRIS &= ~(CS_ALL | (1 << SSD1309_DC) | (1 << SSD1309_RES));
+	TRISCbits.TRISC3 = 0;			// SCK
+	TRISCbits.TRISC5 = 0;			// SDO
+
+	SSPSTAT = 0x40;					// SMP = 0, CKE = 1: data valid on the rising edge
+	SSPCON1 = 0x20 | SSD1309_SPI_CLOCK;	// SSPEN, CKP = 0, master mode with the selected clock
+}
+
+void ssd1309_bus_reset(bool active)
+{
+	if (active)
+	{
+		SSD1309_SPI_LAT &= ~(1 << SSD1309_RES);
+	}
+	else
+	{
+		SSD1309_SPI_LAT |= (1 << SSD1309_RES);
+	}
+}
+
+void ssd1309_bus_writeCmd(UINT8 command)
+{
+	DC_CMD();
+	CS_LOW();
+	SSPBUF = command;
+	SPI_WAIT();
+	CS_HIGH();
+	DC_DATA();
+}
+
+void ssd1309_bus_writeCmdBurst(const UINT8 *commands, UINT8 len)
+{
+	UINT8 next;
+
+	if (len == 0)
+	{
+		return;
+	}
+	DC_CMD();
+	CS_LOW();
+	SSPBUF = *commands++;
+	while (--len)
+	{
+		next = *commands++;			// fetched while the previous byte shifts
+		SPI_WAIT();
+		SSPBUF = next;
+	}
+	SPI_WAIT();
+	CS_HIGH();
+	DC_DATA();
+}
+
+void ssd1309_bus_writeData(UINT8 data)
+{
+	DC_DATA();
+	CS_LOW();
+	SSPBUF = data;
+	SPI_WAIT();
+	CS_HIGH();
+}
+
+void ssd1309_bus_writeDataBurst(const UINT8 *data, UINT16 len)
+{
+	UINT8 next;
+
+	if (len == 0)
+	{
+		return;
+	}
+	DC_DATA();
+	CS_LOW();
+	SSPBUF = *data++;
+	while (--len)
+	{
+		next = *data++;				// fetched while the previous byte shifts
+		SPI_WAIT();
+		SSPBUF = next;
+	}
+	SPI_WAIT();
+	CS_HIGH();
+}
+
+void ssd1309_bus_writeDataFill(UINT8 value, UINT16 len)
+{
+	if (len == 0)
+	{
+		return;
+	}
+	DC_DATA();
+	CS_LOW();
+	SSPBUF = value;
+	while (--len)
+	{
+		SPI_WAIT();
+		SSPBUF = value;
+	}
+	SPI_WAIT();
+	CS_HIGH();
+}
+
+#if SSD1309_PANELS > 1
+
+void ssd1309_bus_select(UINT8 panel)
+{
+	switch (panel)
+	{
+#if SSD1309_PANELS > 2
+		case 2:		csMask = 1 << SSD1309_CS2; break;
+#endif
+		case 1:		csMask = 1 << SSD1309_CS1; break;
+		default:	csMask = 1 << SSD1309_CS; break;
+	}
+}
+
+#endif
+
+#endif /* SSD1309_SPI */
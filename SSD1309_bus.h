@@ -0,0 +1,99 @@
+/**
+ * @file	SSD1309_bus.h
+ * @brief	Bus transport interface of the SSD1309 OLED Driver library.
+ *
+ * The high level functions in SSD1309.c never touch a port directly. Every byte goes
+ * through the functions below, which are implemented once per interface backend:
+ *
+ *   SSD1309_68XX.c		6800 8-Bit parallel interface, bit-banged on PORTA/PORTD
+ *   SSD1309_80XX.c		8080 8-Bit parallel interface, bit-banged on PORTA/PORTD
+ *   SSD1309_SPI.c		4-wire SPI on the MSSP peripheral
+ *   SSD1309_I2C.c		I2C on the MSSP peripheral
+ *   SSD1309_sim.c		host-side GDDRAM simulator for Linux builds (SSD1309_SIM)
+ *
+ * Exactly one backend is compiled, selected by the interface define in SSD1309.h.
+ * This header is private to the library and not meant for user code.
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef SSD1309_BUS_H_
+#define SSD1309_BUS_H_
+
+#include <stdbool.h>
+#include "SSD1309.h"
+
+/**
+  * @brief  configures the interface pins, the display is left released from reset
+  */
+void ssd1309_bus_init(void);
+
+/**
+  * @brief  controls the reset line of the display
+  *
+  * @param	active	true  = hold the display in reset (RES# low)
+  *					false = release the display from reset (RES# high)
+  */
+void ssd1309_bus_reset(bool active);
+
+/**
+  * @brief  writes a command byte to the display
+  *
+  * @param	command	the command byte
+  */
+void ssd1309_bus_writeCmd(UINT8 command);
+
+/**
+  * @brief  writes a list of command bytes to the display in one transaction
+  *
+  *			CS# and D/C# are asserted once for the whole list, only the write strobe
+  *			is toggled per byte.
+  *
+  * @param	*commands	pointer to the command bytes, may point to program memory
+  * @param  len			number of bytes to write
+  */
+void ssd1309_bus_writeCmdBurst(const UINT8 *commands, UINT8 len);
+
+/**
+  * @brief  writes a graphic data byte to the display
+  *
+  * @param	data	the data byte
+  */
+void ssd1309_bus_writeData(UINT8 data);
+
+/**
+  * @brief  writes a run of graphic data bytes to the display
+  *
+  *			CS# and D/C# are asserted once for the whole run, only the write strobe
+  *			is toggled per byte.
+  *
+  * @param	*data	pointer to the data bytes, may point to program memory
+  * @param  len		number of bytes to write
+  */
+void ssd1309_bus_writeDataBurst(const UINT8 *data, UINT16 len);
+
+/**
+  * @brief  writes the same graphic data byte several times to the display
+  *
+  *			Like ssd1309_bus_writeDataBurst(), the data bus is only set once.
+  *
+  * @param	value	the data byte
+  * @param  len		number of bytes to write
+  */
+void ssd1309_bus_writeDataFill(UINT8 value, UINT16 len);
+
+#if SSD1309_PANELS > 1
+
+/**
+  * @brief  selects the panel addressed by the following transactions
+  *
+  *			Each panel has its own CS# line (I2C: its own slave address), the data bus
+  *			and all other lines are shared.
+  *
+  * @param	panel	the panel, 0 to SSD1309_PANELS-1
+  */
+void ssd1309_bus_select(UINT8 panel);
+
+#endif
+
+#endif /* SSD1309_BUS_H_ */
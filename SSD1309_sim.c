@@ -0,0 +1,542 @@
+/**
+ * @file	SSD1309_sim.c
+ * @brief	Host-side simulator backend of the SSD1309 OLED Driver library.
+ *
+ * Compiled instead of a hardware backend when SSD1309_SIM is defined, so the driver
+ * builds and runs on a plain Linux box:
+ *
+ *   gcc -DSSD1309_SIM -I. SSD1309.c SSD1309_sim.c main.c
+ *
+ * The model decodes the command stream like the controller does and keeps its own
+ * 128x64 GDDRAM. It honors page, horizontal and vertical addressing mode, the column
+ * and page windows, segment and COM remap, display start line and display offset.
+ * Of the scroll commands only the one column content scroll moves the GDDRAM, a
+ * continuous scrolling is only tracked to count the data bytes written while it runs.
+ * Every byte is counted, and an instruction cycle (Tcy) estimate of the 8080 bit-bang
+ * backend is accumulated, together with the C18 style delay routines. Define
+ * SSD1309_SIM_SPI or SSD1309_SIM_I2C to count the Tcy of the MSSP SPI or I2C backend instead.
+ * With SSD1309_PANELS > 1 every panel has its own model, the inspection functions
+ * show the selected one.
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "SSD1309.h"
+
+#ifdef SSD1309_SIM
+
+#include "SSD1309_bus.h"
+#include "delays.h"
+
+#define SIM_COLS		128			// GDDRAM size of the controller, independent of the panel
+#define SIM_PAGES		8
+#define SIM_ROWS		(SIM_PAGES*8)
+
+#if defined(SSD1309_SIM_I2C)
+// Tcy cost of the MSSP I2C backend, one SCL period is SSPADD+1 Tcy
+#define SIM_TCY_I2C_BIT	(SSD1309_I2C_SSPADD+1)
+#define SIM_TCY_BURST	(9*SIM_TCY_I2C_BIT + 4)		// per byte: 8 bits and acknowledge, idle poll, SSPBUF write
+#define SIM_TCY_FILL	SIM_TCY_BURST
+#define SIM_TCY_BURST_SETUP	(20*SIM_TCY_I2C_BIT + 20)	// per transaction: start, address, control byte, stop, calls
+#define SIM_TCY_CMD		(SIM_TCY_BURST_SETUP + SIM_TCY_BURST)
+#define SIM_TCY_DATA	SIM_TCY_CMD
+#define SIM_TRANSACTIONS(len)	(((UINT32)(len) + SSD1309_I2C_CHUNK - 1) / SSD1309_I2C_CHUNK)
+#elif defined(SSD1309_SIM_SPI)
+// Tcy cost of the MSSP SPI backend with SCK = Fosc/4, 8 Tcy per byte on the wire
+#define SIM_TCY_CMD		23			// call, D/C# and CS# low, SSPBUF write, shift, BF poll, SSPBUF read, CS# and D/C# high, return
+#define SIM_TCY_DATA	22			// same sequence without D/C#
+#define SIM_TCY_BURST_SETUP	14		// call, length check, D/C# and CS#, last SSPBUF read, CS#, return
+#define SIM_TCY_BURST	12			// per byte: shift, BF poll, SSPBUF read and write, the fetch overlaps the shift
+#define SIM_TCY_FILL	11			// per byte: shift, BF poll, SSPBUF read and write
+#else
+// Tcy cost of the 8080 bit-bang backend, counted from the generated PIC18 code
+#define SIM_TCY_CMD		22			// call, DATA_PORT store, 7 CONTROL_PORT stores, Nop, return
+#define SIM_TCY_DATA	22			// same sequence as a command byte
+#define SIM_TCY_BURST_SETUP	16		// call, 4 CONTROL_PORT stores, length check, return
+#define SIM_TCY_BURST	13			// per byte: pointer read, DATA_PORT store, WR strobe, Nop, loop
+#define SIM_TCY_FILL	10			// per byte: WR strobe, Nop, loop
+#endif
+
+#ifndef SIM_TRANSACTIONS
+#define SIM_TRANSACTIONS(len)	1	// a burst is one transaction
+#endif
+
+static UINT8 gddram[SIM_PAGES][SIM_COLS];
+
+static struct
+{
+	UINT8 mode;						// 0 = horizontal, 1 = vertical, 2 = page addressing mode
+	UINT8 col;						// column address pointer
+	UINT8 page;						// page address pointer
+	UINT8 colStart, colEnd;			// column window for horizontal and vertical mode
+	UINT8 pageStart, pageEnd;		// page window for horizontal and vertical mode
+	UINT8 startLine;
+	UINT8 offset;
+	UINT8 mux;
+	UINT8 contrast;
+	bool segRemap;
+	bool comRemap;
+	bool entireOn;
+	bool inverse;
+	bool displayOn;
+	bool scrolling;
+	bool inReset;
+} sim;
+
+static UINT8 pendingCmd;			// command waiting for its arguments
+static UINT8 argsLeft;
+static UINT8 argIdx;
+static UINT8 args[8];
+
+static ssd1309_simStats_t stats;
+static UINT32 releaseTcy;			// stats.tcy when the reset was released
+
+/**
+  * @brief  puts the model into its power on reset state
+  */
+static void simReset(void)
+{
+	memset(&sim, 0, sizeof(sim));
+	sim.mode = 2;
+	sim.colEnd = SIM_COLS-1;
+	sim.pageEnd = SIM_PAGES-1;
+	sim.mux = SIM_ROWS;
+	sim.contrast = 0x7F;
+	argsLeft = 0;
+}
+
+/**
+  * @brief  number of argument bytes following a command byte
+  */
+static UINT8 argCount(UINT8 cmd)
+{
+	switch (cmd)
+	{
+		case 0x20:					// addressing mode
+		case 0x81:					// contrast
+		case 0xA8:					// multiplex ratio
+		case 0xD3:					// display offset
+		case 0xD5:					// display clock
+		case 0xD9:					// pre-charge period
+		case 0xDA:					// COM pins
+		case 0xDB:					// VCOMH
+		case 0xFD:					// command lock
+			return 1;
+		case 0x21:					// column address
+		case 0x22:					// page address
+		case 0xA3:					// vertical scroll area
+			return 2;
+		case 0x26:					// horizontal scroll setup
+		case 0x27:
+			return 6;
+		case 0x29:					// vertical and horizontal scroll setup
+		case 0x2A:
+		case 0x2C:					// content scroll by one column
+		case 0x2D:
+			return 7;
+		default:
+			return 0;
+	}
+}
+
+/**
+  * @brief  moves the columns start to end of the pages by one, the column moved out comes in on the other side
+  */
+static void contentScroll(bool left)
+{
+	UINT8 page, col, edge;
+	UINT8 start = args[5] & 0x7F;
+	UINT8 end = args[6] & 0x7F;
+
+	for (page = args[1] & 0x07; (page <= (args[3] & 0x07)) && (start < end); page++)
+	{
+		if (left)
+		{
+			edge = gddram[page][sim.segRemap ? (SIM_COLS-1-start) : start];
+			for (col = start; col < end; col++)
+			{
+				gddram[page][sim.segRemap ? (SIM_COLS-1-col) : col] = gddram[page][sim.segRemap ? (SIM_COLS-2-col) : col+1];
+			}
+			gddram[page][sim.segRemap ? (SIM_COLS-1-end) : end] = edge;
+		}
+		else
+		{
+			edge = gddram[page][sim.segRemap ? (SIM_COLS-1-end) : end];
+			for (col = end; col > start; col--)
+			{
+				gddram[page][sim.segRemap ? (SIM_COLS-1-col) : col] = gddram[page][sim.segRemap ? (SIM_COLS-col) : col-1];
+			}
+			gddram[page][sim.segRemap ? (SIM_COLS-1-start) : start] = edge;
+		}
+	}
+}
+
+/**
+  * @brief  executes a complete command with its arguments
+  */
+static void execCmd(UINT8 cmd)
+{
+	if (cmd <= 0x0F)				// lower column start address, page mode only
+	{
+		if (sim.mode == 2)
+		{
+			sim.col = (sim.col & 0xF0) | cmd;
+		}
+	}
+	else if (cmd <= 0x1F)			// higher column start address, page mode only
+	{
+		if (sim.mode == 2)
+		{
+			sim.col = (sim.col & 0x0F) | ((cmd & 0x07) << 4);
+		}
+	}
+	else if ((cmd >= 0x40) && (cmd <= 0x7F))
+	{
+		sim.startLine = cmd & 0x3F;
+	}
+	else if ((cmd >= 0xB0) && (cmd <= 0xB7))	// page start address, page mode only
+	{
+		if (sim.mode == 2)
+		{
+			sim.page = cmd & 0x07;
+		}
+	}
+	else
+	{
+		switch (cmd)
+		{
+			case 0x20: sim.mode = args[0] & 0x03; break;
+			case 0x21:
+				sim.colStart = args[0] & 0x7F;
+				sim.colEnd = args[1] & 0x7F;
+				sim.col = sim.colStart;
+				break;
+			case 0x22:
+				sim.pageStart = args[0] & 0x07;
+				sim.pageEnd = args[1] & 0x07;
+				sim.page = sim.pageStart;
+				break;
+			case 0x2C: contentScroll(false); break;
+			case 0x2D: contentScroll(true); break;
+			case 0x2E: sim.scrolling = false; break;
+			case 0x2F: sim.scrolling = true; break;
+			case 0x81: sim.contrast = args[0]; break;
+			case 0xA0: sim.segRemap = false; break;
+			case 0xA1: sim.segRemap = true; break;
+			case 0xA4: sim.entireOn = false; break;
+			case 0xA5: sim.entireOn = true; break;
+			case 0xA6: sim.inverse = false; break;
+			case 0xA7: sim.inverse = true; break;
+			case 0xA8: sim.mux = (args[0] & 0x3F) + 1; break;
+			case 0xAE: sim.displayOn = false; break;
+			case 0xAF:
+				if (!sim.displayOn)
+				{
+					stats.firstPixelTcy = stats.tcy - releaseTcy;
+				}
+				sim.displayOn = true;
+				break;
+			case 0xC0: sim.comRemap = false; break;
+			case 0xC8: sim.comRemap = true; break;
+			case 0xD3: sim.offset = args[0] & 0x3F; break;
+			default: break;			// timing and analog settings are not modeled
+		}
+	}
+}
+
+/**
+  * @brief  stores a data byte and advances the address pointer like the controller
+  */
+static void storeData(UINT8 data)
+{
+	UINT8 col = sim.segRemap ? (SIM_COLS-1-sim.col) : sim.col;
+
+	if (sim.scrolling)
+	{
+		stats.scrollWrites++;
+	}
+	gddram[sim.page][col] = data;
+
+	switch (sim.mode)
+	{
+		case 0:						// horizontal: column first, then page, inside the window
+			if (sim.col >= sim.colEnd)
+			{
+				sim.col = sim.colStart;
+				sim.page = (sim.page >= sim.pageEnd) ? sim.pageStart : sim.page+1;
+			}
+			else
+			{
+				sim.col++;
+			}
+			break;
+		case 1:						// vertical: page first, then column, inside the window
+			if (sim.page >= sim.pageEnd)
+			{
+				sim.page = sim.pageStart;
+				sim.col = (sim.col >= sim.colEnd) ? sim.colStart : sim.col+1;
+			}
+			else
+			{
+				sim.page++;
+			}
+			break;
+		default:					// page: column wraps inside the page
+			sim.col = (sim.col+1) % SIM_COLS;
+			break;
+	}
+}
+
+void ssd1309_bus_init(void)
+{
+	simReset();						// the model powers up together with the interface
+}
+
+void ssd1309_bus_reset(bool active)
+{
+	if (active)
+	{
+		simReset();
+		sim.inReset = true;
+	}
+	else
+	{
+		sim.inReset = false;
+		releaseTcy = stats.tcy;
+	}
+}
+
+/**
+  * @brief  feeds one byte into the command decoder
+  */
+static void decodeCmd(UINT8 command)
+{
+	if (sim.inReset)
+	{
+		return;
+	}
+	if (argsLeft)
+	{
+		args[argIdx++] = command;
+		if (--argsLeft == 0)
+		{
+			execCmd(pendingCmd);
+		}
+		return;
+	}
+	argsLeft = argCount(command);
+	if (argsLeft)
+	{
+		pendingCmd = command;
+		argIdx = 0;
+	}
+	else
+	{
+		execCmd(command);
+	}
+}
+
+void ssd1309_bus_writeCmd(UINT8 command)
+{
+	stats.cmdBytes++;
+	stats.transactions++;
+	stats.tcy += SIM_TCY_CMD;
+
+	decodeCmd(command);
+}
+
+void ssd1309_bus_writeCmdBurst(const UINT8 *commands, UINT8 len)
+{
+	if (len == 0)
+	{
+		return;
+	}
+	stats.cmdBytes += len;
+	stats.transactions += SIM_TRANSACTIONS(len);
+	stats.tcy += SIM_TRANSACTIONS(len) * SIM_TCY_BURST_SETUP + (UINT32)len * SIM_TCY_BURST;
+
+	while (len--)
+	{
+		decodeCmd(*commands++);
+	}
+}
+
+void ssd1309_bus_writeData(UINT8 data)
+{
+	stats.dataBytes++;
+	stats.transactions++;
+	stats.tcy += SIM_TCY_DATA;
+
+	if (!sim.inReset)
+	{
+		storeData(data);
+	}
+}
+
+void ssd1309_bus_writeDataBurst(const UINT8 *data, UINT16 len)
+{
+	if (len == 0)
+	{
+		return;
+	}
+	stats.dataBytes += len;
+	stats.transactions += SIM_TRANSACTIONS(len);
+	stats.tcy += SIM_TRANSACTIONS(len) * SIM_TCY_BURST_SETUP + (UINT32)len * SIM_TCY_BURST;
+
+	while (len--)
+	{
+		if (!sim.inReset)
+		{
+			storeData(*data);
+		}
+		data++;
+	}
+}
+
+void ssd1309_bus_writeDataFill(UINT8 value, UINT16 len)
+{
+	if (len == 0)
+	{
+		return;
+	}
+	stats.dataBytes += len;
+	stats.transactions += SIM_TRANSACTIONS(len);
+	stats.tcy += SIM_TRANSACTIONS(len) * SIM_TCY_BURST_SETUP + (UINT32)len * SIM_TCY_FILL;
+
+	while (len--)
+	{
+		if (!sim.inReset)
+		{
+			storeData(value);
+		}
+	}
+}
+
+
+#if SSD1309_PANELS > 1
+
+/**
+  * @brief  the models of the panels that are not selected
+  */
+static struct
+{
+	UINT8 gddram[SIM_PAGES][SIM_COLS];
+	UINT8 sim[sizeof(sim)];
+	UINT8 pendingCmd;
+	UINT8 argsLeft;
+	UINT8 argIdx;
+	UINT8 args[8];
+} panels[SSD1309_PANELS];
+static UINT8 selectedPanel = 0;
+
+void ssd1309_bus_select(UINT8 panel)
+{
+	if ((panel >= SSD1309_PANELS) || (panel == selectedPanel))
+	{
+		return;
+	}
+	memcpy(panels[selectedPanel].gddram, gddram, sizeof(gddram));
+	memcpy(panels[selectedPanel].sim, &sim, sizeof(sim));
+	panels[selectedPanel].pendingCmd = pendingCmd;
+	panels[selectedPanel].argsLeft = argsLeft;
+	panels[selectedPanel].argIdx = argIdx;
+	memcpy(panels[selectedPanel].args, args, sizeof(args));
+
+	memcpy(gddram, panels[panel].gddram, sizeof(gddram));
+	memcpy(&sim, panels[panel].sim, sizeof(sim));
+	pendingCmd = panels[panel].pendingCmd;
+	argsLeft = panels[panel].argsLeft;
+	argIdx = panels[panel].argIdx;
+	memcpy(args, panels[panel].args, sizeof(args));
+	selectedPanel = panel;
+}
+
+#endif
+
+/*#############################################################################
+########################## C18 delay routines #################################
+#############################################################################*/
+
+void Delay1TCYx(unsigned char unit)
+{
+	stats.tcy += unit ? unit : 256;
+}
+
+void Delay10TCYx(unsigned char unit)
+{
+	stats.tcy += 10UL * (unit ? unit : 256);
+}
+
+void Delay100TCYx(unsigned char unit)
+{
+	stats.tcy += 100UL * (unit ? unit : 256);
+}
+
+void Delay1KTCYx(unsigned char unit)
+{
+	stats.tcy += 1000UL * (unit ? unit : 256);
+}
+
+void Delay10KTCYx(unsigned char unit)
+{
+	stats.tcy += 10000UL * (unit ? unit : 256);
+}
+
+
+/*#############################################################################
+######################## simulator inspection functions #######################
+#############################################################################*/
+
+void ssd1309_sim_resetStats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+const ssd1309_simStats_t* ssd1309_sim_getStats(void)
+{
+	return &stats;
+}
+
+const UINT8* ssd1309_sim_getGddram(void)
+{
+	return &gddram[0][0];
+}
+
+bool ssd1309_sim_getPixel(UINT8 x, UINT8 y)
+{
+	UINT8 row, ramRow;
+	bool on;
+
+	if ((x >= SIM_COLS) || (y >= sim.mux) || !sim.displayOn)
+	{
+		return false;
+	}
+	if (sim.entireOn)
+	{
+		return true;
+	}
+
+	row = sim.comRemap ? (sim.mux-1-y) : y;					// COM scan direction
+	ramRow = (row + sim.startLine + sim.offset) % SIM_ROWS;	// start line and offset rotate the RAM
+	on = (gddram[ramRow/8][x] >> (ramRow%8)) & 0x01;
+
+	return sim.inverse ? !on : on;
+}
+
+void ssd1309_sim_print(void)
+{
+	UINT8 x, y;
+
+	for (y=0; y<SSD1309_ROW; y++)
+	{
+		for (x=0; x<SSD1309_COL; x++)
+		{
+			putchar(ssd1309_sim_getPixel(x, y) ? '#' : '.');
+		}
+		putchar('\n');
+	}
+}
+
+#endif /* SSD1309_SIM */
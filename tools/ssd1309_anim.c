@@ -0,0 +1,125 @@
+/**
+ * @file	ssd1309_anim.c
+ * @brief	Host-side generator for the delta frame animations of ssd1309_anim_init().
+ *
+ * Reads one Image2GLCD array ("LSB to MSB Top to Bottom") per frame, compresses the first
+ * frame as the key frame and stores only the changed spans of the following frames.
+ *
+ *   gcc tools/ssd1309_anim.c -o ssd1309_anim
+ *   ./ssd1309_anim <width> <height> <period ms> <name> frame0.c frame1.c ... > anim.c
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1309_rle.h"
+
+#define MAX_FRAMES	255
+#define MERGE_GAP	4				// unchanged bytes that are cheaper to send again than a new span
+
+static unsigned char frame[MAX_FRAMES][255*255];
+static unsigned char out[3 + 2 + 2*255*255 + MAX_FRAMES*(1 + 3*255 + 255*255)];
+
+/**
+  * @brief  appends the spans that turn frame a into frame b
+  *
+  * @param	gap		unchanged bytes that are merged into a span
+  * @return	the new size of out[], 0 if there are more than 255 spans
+  */
+static size_t delta(const unsigned char *a, const unsigned char *b, int width, int pages, int gap, size_t size)
+{
+	size_t count = size++;
+	int page, col, start, end, spans = 0;
+
+	for(page=0;page<pages;page++)
+	{
+		for(col=0;col<width;col++)
+		{
+			if (a[page*width+col] == b[page*width+col])
+			{
+				continue;
+			}
+			start = col;
+			end = col;
+			for(col++;(col<width)&&(col-end<=gap+1)&&(col-start<255);col++)	// extends the span over small gaps
+			{
+				if (a[page*width+col] != b[page*width+col])
+				{
+					end = col;
+				}
+			}
+			col = end;
+			if (++spans > 255)
+			{
+				return 0;
+			}
+			out[size++] = (unsigned char)page;
+			out[size++] = (unsigned char)start;
+			out[size++] = (unsigned char)(end - start + 1);
+			memcpy(&out[size], &b[page*width+start], end - start + 1);
+			size += end - start + 1;
+		}
+	}
+	out[count] = (unsigned char)spans;
+	return size;
+}
+
+int main(int argc, char *argv[])
+{
+	int width, height, pages, period, frames, i, gap;
+	size_t len, size, start, next;
+	FILE *file;
+
+	if ((argc < 6) || (argc - 5 > MAX_FRAMES))
+	{
+		fprintf(stderr, "usage: %s <width> <height> <period ms> <name> frame0.c frame1.c ... > anim.c\n", argv[0]);
+		return 1;
+	}
+	width = atoi(argv[1]);
+	height = atoi(argv[2]);
+	period = atoi(argv[3]);
+	frames = argc - 5;
+	pages = (height+7)/8;
+	if ((width < 1) || (width > 255) || (height < 1) || (height > 255*8) || (period < 0) || (period > 0xFFFF))
+	{
+		fprintf(stderr, "width must be 1-255, height 1-%d, period 0-65535\n", 255*8);
+		return 1;
+	}
+	len = (size_t)width * pages;
+	for(i=0;i<frames;i++)
+	{
+		file = fopen(argv[5+i], "r");
+		if (file == NULL)
+		{
+			perror(argv[5+i]);
+			return 1;
+		}
+		if (rleReadArray(file, frame[i], len) != len)
+		{
+			fprintf(stderr, "%s: %lu bytes expected\n", argv[5+i], (unsigned long)len);
+			return 1;
+		}
+		fclose(file);
+	}
+
+	out[0] = (unsigned char)frames;
+	out[1] = (unsigned char)(period & 0xFF);
+	out[2] = (unsigned char)(period >> 8);
+	size = 3 + rleEncode(frame[0], (unsigned char)width, (unsigned char)pages, &out[3]);
+	start = size;
+	for(i=0;i<frames;i++)					// the delta of the last frame leads back to the key frame
+	{
+		for(gap=MERGE_GAP;(next = delta(frame[i], frame[(i+1)%frames], width, pages, gap, size)) == 0;gap++)
+		{
+		}
+		size = next;
+	}
+
+	printf("// %d frames %dx%d, %lu ms, %lu bytes raw, key frame %lu + deltas %lu = %lu bytes\n",
+		frames, width, height, (unsigned long)period, (unsigned long)(frames*len),
+		(unsigned long)start, (unsigned long)(size - start), (unsigned long)size);
+	rlePrintArray(argv[4], out, size);
+	return 0;
+}
@@ -0,0 +1,453 @@
+/**
+ * @file	ssd1309_bench.c
+ * @brief	Host-side check and speed test of the pixel, line, rectangle and circle primitives.
+ *
+ * Draws random cases of each primitive with the driver and with a reference that plots
+ * every pixel on its own through ssd1309_drawPixel(), and compares the framebuffers.
+ * Then measures the drawing speed of both in Mpixel/s. No bus traffic is involved,
+ * the framebuffer is not flushed.
+ *
+ *   gcc -O2 -DSSD1309_SIM -DSSD1309_FRAMEBUFFER -I. SSD1309.c SSD1309_sim.c tools/ssd1309_bench.c -o ssd1309_bench
+ *   ./ssd1309_bench [cases]		(default 3000 random cases per primitive)
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SSD1309.h"
+
+#ifndef SSD1309_FRAMEBUFFER
+#error "ssd1309_bench needs -DSSD1309_FRAMEBUFFER"
+#endif
+
+#define BENCH_TIME	0.2					// seconds per measurement
+
+/*#############################################################################
+############ reference versions, one ssd1309_drawPixel() per pixel ############
+#############################################################################*/
+
+static void plotRef(int x, int y, UINT8 color)
+{
+	if ((y >= 0) && (y < SSD1309_ROW))		// ssd1309_drawPixel() takes the row as UINT8
+	{
+		ssd1309_drawPixel(x, y, color);
+	}
+}
+
+static void hLineRef(int x, UINT8 y, UINT8 w, UINT8 color)
+{
+	int i;
+
+	for(i=0;i<w;i++)
+	{
+		plotRef(x+i, y, color);
+	}
+}
+
+static void vLineRef(int x, UINT8 y, UINT8 h, UINT8 color)
+{
+	int i;
+
+	for(i=0;i<h;i++)
+	{
+		plotRef(x, y+i, color);
+	}
+}
+
+static void lineRef(int x0, UINT8 y0, int x1, UINT8 y1, UINT8 color)
+{
+	int dx, dy, err, step, x, y;
+
+	if (x0 > x1)
+	{
+		x = x0; x0 = x1; x1 = x;
+		y = y0; y0 = y1; y1 = y;
+	}
+	dx = x1 - x0;
+	dy = (y1 > y0) ? (y1 - y0) : (y0 - y1);
+	step = (y1 > y0) ? 1 : -1;
+	if (dx >= dy)
+	{
+		err = dx/2;
+		for(x=x0,y=y0;x<=x1;x++)
+		{
+			plotRef(x, y, color);
+			err -= dy;
+			if (err < 0)
+			{
+				y += step;
+				err += dx;
+			}
+		}
+	}
+	else
+	{
+		err = dy/2;
+		for(x=x0,y=y0;y!=(int)y1+step;y+=step)
+		{
+			plotRef(x, y, color);
+			err -= dx;
+			if (err < 0)
+			{
+				x++;
+				err += dy;
+			}
+		}
+	}
+}
+
+static void rectRef(int x, UINT8 y, UINT8 w, UINT8 h, UINT8 color)
+{
+	int i;
+
+	if ((w == 0) || (h == 0))
+	{
+		return;
+	}
+	for(i=0;i<w;i++)
+	{
+		plotRef(x+i, y, color);
+		plotRef(x+i, (int)y+h-1, color);
+	}
+	for(i=0;i<h;i++)
+	{
+		plotRef(x, (int)y+i, color);
+		plotRef((int)x+w-1, (int)y+i, color);
+	}
+}
+
+static void fillRectRef(UINT8 x, UINT8 y, UINT8 w, UINT8 h, UINT8 color)
+{
+	int i;
+
+	for(i=0;i<h;i++)
+	{
+		hLineRef(x, (int)y+i, w, color);
+	}
+}
+
+/**
+  * @brief  plots the eighths of a circle outline, the quarters are moved apart by dx and dy
+  */
+static void arcsRef(int cx, int cy, int r, int dx, int dy, UINT8 color)
+{
+	int f = 1 - r;
+	int ddx = 1;
+	int ddy = -2 * r;
+	int x = 0;
+	int y = r;
+
+	while (x <= y)
+	{
+		plotRef(cx - y, cy - x, color);
+		plotRef(cx - x, cy - y, color);
+		plotRef(cx + dx + x, cy - y, color);
+		plotRef(cx + dx + y, cy - x, color);
+		plotRef(cx + dx + y, cy + dy + x, color);
+		plotRef(cx + dx + x, cy + dy + y, color);
+		plotRef(cx - x, cy + dy + y, color);
+		plotRef(cx - y, cy + dy + x, color);
+		if (f >= 0)
+		{
+			y--;
+			ddy += 2;
+			f += ddy;
+		}
+		x++;
+		ddx += 2;
+		f += ddx;
+	}
+}
+
+static void roundRectRef(int x, UINT8 y, UINT8 w, UINT8 h, UINT8 r, UINT8 color)
+{
+	int i;
+
+	if ((w == 0) || (h == 0))
+	{
+		return;
+	}
+	if (r > (w-1)/2)
+	{
+		r = (w-1)/2;
+	}
+	if (r > (h-1)/2)
+	{
+		r = (h-1)/2;
+	}
+	for(i=r;i<=w-1-r;i++)
+	{
+		plotRef(x+i, y, color);
+		plotRef(x+i, (int)y+h-1, color);
+	}
+	for(i=r;i<=h-1-r;i++)
+	{
+		plotRef(x, (int)y+i, color);
+		plotRef((int)x+w-1, (int)y+i, color);
+	}
+	arcsRef(x+r, (int)y+r, r, w-1-2*r, h-1-2*r, color);
+}
+
+static void circleRef(int cx, UINT8 cy, UINT8 r, UINT8 color)
+{
+	arcsRef(cx, cy, r, 0, 0, color);
+}
+
+static void fillCircleRef(int cx, UINT8 cy, UINT8 r, UINT8 color)
+{
+	int height[256];						// the outline of circleRef() per column, height[r+dx] rows up and down
+	int f = 1 - r;
+	int ddx = 1;
+	int ddy = -2 * (int)r;
+	int x = 0;
+	int y = r;
+	int i, j;
+
+	for(i=0;i<=2*r;i++)
+	{
+		height[i] = -1;
+	}
+	while (x <= y)
+	{
+		if (y > height[r+x]) height[r+x] = height[r-x] = y;
+		if (x > height[r+y]) height[r+y] = height[r-y] = x;
+		if (f >= 0)
+		{
+			y--;
+			ddy += 2;
+			f += ddy;
+		}
+		x++;
+		ddx += 2;
+		f += ddx;
+	}
+	for(i=0;i<=2*r;i++)						// every pixel between the top and the bottom of the outline
+	{
+		for(j=-height[i];j<=height[i];j++)
+		{
+			plotRef(cx-r+i, (int)cy+j, color);
+		}
+	}
+}
+
+/*#############################################################################
+################################# random check ################################
+#############################################################################*/
+
+static UINT8 before[SSD1309_BUFFER_SIZE];
+static UINT8 expect[SSD1309_BUFFER_SIZE];
+
+static int randRange(int min, int max)
+{
+	return min + rand() % (max - min + 1);
+}
+
+/**
+  * @brief  draws one random case with the driver and the reference, starting from the same random content
+  *
+  * @return	0 when both framebuffers are the same
+  */
+static int checkCase(int primitive, char *text)
+{
+	UINT8 *fb = ssd1309_getFramebuffer();
+	int x0 = randRange(-20, SSD1309_COL+20);
+	int x1 = randRange(-20, SSD1309_COL+20);
+	UINT8 y0 = randRange(0, SSD1309_ROW-1);
+	UINT8 y1 = randRange(0, SSD1309_ROW-1);
+	UINT8 w = randRange(0, SSD1309_COL);
+	UINT8 h = randRange(0, SSD1309_ROW);
+	UINT8 r = randRange(0, SSD1309_ROW/2);
+	UINT8 color = rand() & 1;
+	unsigned i;
+
+	for(i=0;i<sizeof(before);i++)
+	{
+		before[i] = rand();
+	}
+	sprintf(text, "x0=%d y0=%u x1=%d y1=%u w=%u h=%u r=%u color=%u", x0, y0, x1, y1, w, h, r, color);
+
+	memcpy(fb, before, sizeof(before));
+	switch (primitive)
+	{
+		case 0: hLineRef(x0, y0, w, color); break;
+		case 1: vLineRef(x0, y0, h, color); break;
+		case 2: lineRef(x0, y0, x1, y1, color); break;
+		case 3: rectRef(x0, y0, w, h, color); break;
+		case 4: roundRectRef(x0, y0, w, h, r, color); break;
+		case 5: circleRef(x0, y0, r, color); break;
+		case 6: fillCircleRef(x0, y0, r, color); break;
+		default: fillRectRef(x0, y0, w, h, color); break;
+	}
+	memcpy(expect, fb, sizeof(expect));
+
+	memcpy(fb, before, sizeof(before));
+	switch (primitive)
+	{
+		case 0: ssd1309_drawHLine(x0, y0, w, color); break;
+		case 1: ssd1309_drawVLine(x0, y0, h, color); break;
+		case 2: ssd1309_drawLine(x0, y0, x1, y1, color); break;
+		case 3: ssd1309_drawRect(x0, y0, w, h, color); break;
+		case 4: ssd1309_drawRoundRect(x0, y0, w, h, r, color); break;
+		case 5: ssd1309_drawCircle(x0, y0, r, color); break;
+		case 6: ssd1309_fillCircle(x0, y0, r, color); break;
+		default: ssd1309_fillRect(x0, y0, w, h, color); break;
+	}
+	return memcmp(fb, expect, sizeof(expect));
+}
+
+/*#############################################################################
+################################## speed test #################################
+#############################################################################*/
+
+#define PRIMITIVES	8
+
+static const char *names[PRIMITIVES] =
+{
+	"drawHLine", "drawVLine", "drawLine", "drawRect",
+	"drawRoundRect", "drawCircle", "fillCircle", "fillRect"
+};
+
+static const char *shapes[PRIMITIVES] =
+{
+	"drawHLine(100 px)", "drawVLine(60 px)", "drawLine(random)", "drawRect(100x60)",
+	"drawRoundRect(100x60, r=10)", "drawCircle(r=30)", "fillCircle(r=30)", "fillRect(100x60)"
+};
+
+static double seconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+  * @brief  draws the test shape of a primitive, the random lines come from the table
+  */
+static void drawShape(int primitive, int reference, const UINT8 *line, UINT8 color)
+{
+	switch (primitive)
+	{
+		case 0: if (reference) hLineRef(14, 20, 100, color); else ssd1309_drawHLine(14, 20, 100, color); break;
+		case 1: if (reference) vLineRef(64, 2, 60, color); else ssd1309_drawVLine(64, 2, 60, color); break;
+		case 2: if (reference) lineRef(line[0], line[1], line[2], line[3], color); else ssd1309_drawLine(line[0], line[1], line[2], line[3], color); break;
+		case 3: if (reference) rectRef(14, 2, 100, 60, color); else ssd1309_drawRect(14, 2, 100, 60, color); break;
+		case 4: if (reference) roundRectRef(14, 2, 100, 60, 10, color); else ssd1309_drawRoundRect(14, 2, 100, 60, 10, color); break;
+		case 5: if (reference) circleRef(64, 31, 30, color); else ssd1309_drawCircle(64, 31, 30, color); break;
+		case 6: if (reference) fillCircleRef(64, 31, 30, color); else ssd1309_fillCircle(64, 31, 30, color); break;
+		default: if (reference) fillRectRef(14, 2, 100, 60, color); else ssd1309_fillRect(14, 2, 100, 60, color); break;
+	}
+}
+
+/**
+  * @brief  returns the pixels set by the test shape, a random line counts max(dx,dy)+1 pixels
+  */
+static unsigned long shapePixels(int primitive, const UINT8 *line)
+{
+	UINT8 *fb = ssd1309_getFramebuffer();
+	unsigned long pixels = 0;
+	unsigned i;
+	int dx, dy;
+
+	if (primitive == 2)
+	{
+		dx = abs(line[2] - line[0]);
+		dy = abs(line[3] - line[1]);
+		return ((dx > dy) ? dx : dy) + 1;
+	}
+	memset(fb, 0, SSD1309_BUFFER_SIZE);
+	drawShape(primitive, 0, line, SSD1309_WHITE);
+	for(i=0;i<SSD1309_BUFFER_SIZE;i++)
+	{
+		pixels += __builtin_popcount(fb[i]);
+	}
+	return pixels;
+}
+
+/**
+  * @brief  draws the test shape alternately white and black for BENCH_TIME seconds
+  *
+  * @return	Mpixel/s
+  */
+static double speed(int primitive, int reference, const UINT8 (*lines)[4], int lineCount)
+{
+	unsigned long pixels = 0, calls = 0;
+	double start = seconds(), elapsed;
+
+	do
+	{
+		int i;
+
+		for(i=0;i<256;i++,calls++)
+		{
+			const UINT8 *line = lines[calls % lineCount];
+
+			drawShape(primitive, reference, line, (calls & 1) ? SSD1309_BLACK : SSD1309_WHITE);
+		}
+		elapsed = seconds() - start;
+	} while (elapsed < BENCH_TIME);
+	if (primitive == 2)
+	{
+		for(;calls;calls--)
+		{
+			pixels += shapePixels(2, lines[(calls-1) % lineCount]);
+		}
+	}
+	else
+	{
+		pixels = calls * shapePixels(primitive, lines[0]);
+	}
+	return pixels / elapsed / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+	static UINT8 lines[1024][4];
+	int cases = (argc > 1) ? atoi(argv[1]) : 3000;
+	int primitive, i, failed = 0;
+	char text[96], first[96];
+
+	ssd1309_init();
+	srand(1);
+
+	printf("%-28s %8s %8s\n", "random check", "cases", "failed");
+	for(primitive=0;primitive<PRIMITIVES;primitive++)
+	{
+		int bad = 0;
+
+		for(i=0;i<cases;i++)
+		{
+			if (checkCase(primitive, (bad == 0) ? first : text))
+			{
+				bad++;
+			}
+		}
+		printf("%-28s %8d %8d\n", names[primitive], cases, bad);
+		if (bad)
+		{
+			printf("  first mismatch: %s\n", first);
+		}
+		failed += bad;
+	}
+
+	for(i=0;i<1024;i++)
+	{
+		lines[i][0] = randRange(0, SSD1309_COL-1);
+		lines[i][1] = randRange(0, SSD1309_ROW-1);
+		lines[i][2] = randRange(0, SSD1309_COL-1);
+		lines[i][3] = randRange(0, SSD1309_ROW-1);
+	}
+	printf("\n%-28s %10s %10s\n", "Mpixel/s", "per pixel", "driver");
+	for(primitive=0;primitive<PRIMITIVES;primitive++)
+	{
+		double ref = speed(primitive, 1, (const UINT8 (*)[4])lines, 1024);
+		double drv = speed(primitive, 0, (const UINT8 (*)[4])lines, 1024);
+
+		printf("%-28s %10.0f %10.0f\n", shapes[primitive], ref, drv);
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,369 @@
+/**
+ * @file	ssd1309_profile.c
+ * @brief	Host-side profiler for the SSD1309 OLED Driver library.
+ *
+ * Runs the public ssd1309_* functions against the simulator backend and prints the
+ * bus bytes and the estimated instruction cycles (Tcy) of each call. The functions of
+ * the framebuffer and strip modes, the canvas and the console are included when they
+ * are built.
+ *
+ *   gcc -DSSD1309_SIM -I. SSD1309.c SSD1309_sim.c tools/ssd1309_profile.c -o ssd1309_profile
+ *   ./ssd1309_profile [-p]		(-p prints the panel content at the end)
+ *
+ * Add -DSSD1309_FRAMEBUFFER to profile the framebuffer mode, -DSSD1309_SIM_SPI or
+ * -DSSD1309_SIM_I2C for the Tcy of the SPI or I2C backend. In framebuffer mode the pixel,
+ * line, rectangle and circle primitives are profiled together with the flush that sends
+ * them, their drawing speed is measured by tools/ssd1309_bench.c. Build with
+ * -DSSD1309_STRIP for ssd1309_renderStrips() and with -DSSD1309_FRAMEBUFFER
+ * -DSSD1309_PANELS=2 for the canvas of two panels.
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "SSD1309.h"
+
+static const UINT8 testPic[2*32] =
+{
+	0xFF,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0xFF,
+	0xFF,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0xFF,
+	0xFF,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0xFF,
+	0xFF,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0xFF
+};
+
+static const UINT8 testPicRLE[20] =				// testPic compressed with tools/ssd1309_rle.c
+{
+	0x20,0x02,0x00,0xFF,0xCD,0x01,0xC1,0xFF,0xCD,0x01,0xC1,0xFF,0xCD,0x80,0xC1,0xFF,
+	0xCD,0x80,0x00,0xFF
+};
+
+#ifndef SSD1309_STRIP
+static const UINT8 testAnim[53] =				// testPic and a frame with a changed middle, tools/ssd1309_anim.c
+{
+	0x02,0x64,0x00,0x20,0x02,0x00,0xFF,0xCD,0x01,0xC1,0xFF,0xCD,0x01,0xC1,0xFF,0xCD,
+	0x80,0xC1,0xFF,0xCD,0x80,0x00,0xFF,0x02,0x00,0x06,0x04,0x3D,0x3D,0x3D,0x3D,0x01,
+	0x06,0x04,0xBC,0xBC,0xBC,0xBC,0x02,0x00,0x06,0x04,0x01,0x01,0x01,0x01,0x01,0x06,
+	0x04,0x80,0x80,0x80,0x80
+};
+#endif
+
+static const UINT8 boardInit[] =				// a board specific table for ssd1309_initWith()
+{
+	0x81, 0xCF,									// Set Contrast Control
+	0xD9, 0xF1									// Set Pre-Charge Period
+};
+
+#ifdef SSD1309_CANVAS
+static UINT8 secondBuffer[SSD1309_BUFFER_SIZE];
+
+/**
+  * @brief  draws across the two panels of the canvas
+  */
+static void drawCanvas(void)
+{
+	ssd1309_drawLine(0, 0, 2*SSD1309_COL-1, SSD1309_ROW-1, SSD1309_WHITE);
+	ssd1309_drawCircle(SSD1309_COL, SSD1309_ROW/2, 12, SSD1309_WHITE);
+}
+#endif
+
+#ifdef SSD1309_STRIP
+/**
+  * @brief  draws a screen strip by strip for ssd1309_renderStrips()
+  */
+static void drawStrip(UINT8 startPage, UINT8 endPage)
+{
+	(void)startPage;
+	(void)endPage;
+	ssd1309_print("Strips", 0, 0);
+	ssd1309_drawRoundRect(0, 10, 60, 30, 5, SSD1309_WHITE);
+	ssd1309_drawLine(0, 10, 59, 39, SSD1309_WHITE);
+	ssd1309_fillCircle(90, 30, 20, SSD1309_WHITE);
+	ssd1309_blit(testPic, 32, 16, 74, 22, SSD1309_ROP_XOR);
+	ssd1309_drawBargraph(50, 6, 7, 0, 128);
+}
+#endif
+
+/**
+  * @brief  prints the counters of the last profiled call and restarts them
+  */
+static void report(const char *name)
+{
+	const ssd1309_simStats_t *stats = ssd1309_sim_getStats();
+
+	printf("%-34s %8lu %8lu %8lu %10lu\n", name,
+		(unsigned long)stats->cmdBytes, (unsigned long)stats->dataBytes,
+		(unsigned long)stats->transactions, (unsigned long)stats->tcy);
+	ssd1309_sim_resetStats();
+}
+
+int main(int argc, char *argv[])
+{
+	char name[40];
+	UINT16 tick, calls;
+#ifdef SSD1309_FRAMEBUFFER
+	UINT8 *fb;
+	UINT8 i;
+#endif
+#ifndef SSD1309_STRIP
+	ssd1309_readout_t readout;
+	ssd1309_bargraph_t bargraph;
+	ssd1309_anim_t anim;
+#endif
+#if SSD1309_PANELS > 1
+	ssd1309_panel_t panel;					// the calls are profiled on the first panel
+#endif
+#ifdef SSD1309_CANVAS
+	ssd1309_panel_t second;
+	ssd1309_panel_t *const canvas[2] = { &panel, &second };
+#endif
+
+	printf("%-34s %8s %8s %8s %10s\n", "call", "cmd", "data", "trans", "Tcy");
+
+#if SSD1309_PANELS > 1
+	ssd1309_panel_init(&panel, 0, NULL);
+	ssd1309_panel_select(&panel);
+#endif
+	ssd1309_sim_resetStats();
+	ssd1309_init_begin();
+	for(tick=0,calls=1;!ssd1309_init_poll(tick);tick++,calls++);	// one call per ms
+	sprintf(name, "ssd1309_init_poll(%u calls)", calls);
+	report(name);
+
+	ssd1309_initWith(boardInit, sizeof(boardInit));
+	report("ssd1309_initWith(4 bytes)");
+
+	ssd1309_init();
+	report("ssd1309_init()");
+
+#ifndef SSD1309_STRIP
+	ssd1309_console_clear();
+	report("ssd1309_console_clear()");
+
+	ssd1309_console_puts("line 1\nline 2\nline 3\nline 4\nline 5\nline 6\nline 7\nline 8\nline 9\n");
+	report("ssd1309_console_puts(9 lines)");
+
+	ssd1309_console_putc('>');
+	report("ssd1309_console_putc()");
+
+	ssd1309_console_clear();				// the other calls need the start line at 0
+	report("ssd1309_console_clear(scrolled)");
+#endif
+
+	ssd1309_clear();
+	report("ssd1309_clear()");
+
+	ssd1309_putc('A', 0, 0);
+	report("ssd1309_putc()");
+
+	ssd1309_putcProp('A', 0, 0);
+	report("ssd1309_putcProp()");
+
+	ssd1309_print("Hello World", 0, 0);
+	report("ssd1309_print(11 chars)");
+
+	ssd1309_print_P("Hello World", 1, 0);
+	report("ssd1309_print_P(11 chars)");
+
+	ssd1309_printProp("Hello World", 1, 70);
+	report("ssd1309_printProp(11 chars)");
+
+	ssd1309_printf(2, 0, "T=%d", 42);
+	report("ssd1309_printf(\"T=%d\")");
+
+	ssd1309_printf_P(3, 0, "T=%d", 42);
+	report("ssd1309_printf_P(\"T=%d\")");
+
+	ssd1309_putBigDigit('8', 4, 0);
+	report("ssd1309_putBigDigit()");
+
+	ssd1309_print_bigDigit("12.34", 4, 0);
+	report("ssd1309_print_bigDigit(5 chars)");
+
+#ifndef SSD1309_STRIP
+	ssd1309_readout_init(&readout, 4, 80, 3, SSD1309_READOUT_BIG);
+	ssd1309_readout_print(&readout, "42");
+	report("ssd1309_readout_print(3 new)");
+
+	ssd1309_readout_print(&readout, "43");
+	report("ssd1309_readout_print(1 changed)");
+
+	ssd1309_readout_invalidate(&readout);
+	ssd1309_readout_print(&readout, "43");
+	report("ssd1309_readout_print(invalidated)");
+#endif
+
+	ssd1309_showPic(testPic, 0, 1, 96, 32);
+	report("ssd1309_showPic(32x16)");
+
+	ssd1309_showPicRLE(testPicRLE, 0, 96);
+	report("ssd1309_showPicRLE(32x16)");
+
+#ifndef SSD1309_STRIP
+	ssd1309_anim_init(&anim, testAnim, 0, 96);
+	report("ssd1309_anim_init(32x16)");
+
+	ssd1309_anim_next(&anim);
+	report("ssd1309_anim_next(2 spans)");
+
+	for(tick=0,calls=0;tick<=300;tick++)	// 100 ms frame period, one call per ms
+	{
+		calls += ssd1309_anim_poll(&anim, tick);
+	}
+	sprintf(name, "ssd1309_anim_poll(%u frames/300 ms)", calls);
+	report(name);
+#endif
+
+	ssd1309_showPicWindow(testPic, 32, 16, 8, 0, 0, 1, 96, 127);
+	report("ssd1309_showPicWindow(32x16, x+8)");
+
+	ssd1309_showPicWindow(testPic, 32, 16, 8, 3, 0, 1, 96, 127);
+	report("ssd1309_showPicWindow(32x16, y+3)");
+
+	ssd1309_drawBargraph(50, 6, 7, 0, 128);
+	report("ssd1309_drawBargraph(128x16)");
+
+	ssd1309_drawBargraph(70, 2, 5, 100, 20);
+	report("ssd1309_drawBargraph(20x32)");
+
+#ifndef SSD1309_STRIP
+	ssd1309_bargraph_init(&bargraph, 6, 7, 0, 128);
+	ssd1309_bargraph_set(&bargraph, 50);
+	ssd1309_sim_resetStats();
+	ssd1309_bargraph_set(&bargraph, 51);
+	report("ssd1309_bargraph_set(128x16, +1%)");
+
+	ssd1309_bargraph_init(&bargraph, 2, 5, 100, 20);
+	ssd1309_bargraph_set(&bargraph, 70);
+	ssd1309_sim_resetStats();
+	ssd1309_bargraph_set(&bargraph, 75);
+	report("ssd1309_bargraph_set(20x32, +5%)");
+
+	ssd1309_bargraph_invalidate(&bargraph);
+	ssd1309_bargraph_set(&bargraph, 75);
+	report("ssd1309_bargraph_set(invalidated)");
+#endif
+
+#ifdef SSD1309_FRAMEBUFFER
+	ssd1309_flush();						// the primitives only change the framebuffer, the flush sends them
+	ssd1309_sim_resetStats();
+	ssd1309_drawPixel(127, 15, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_drawPixel()+flush");
+
+	ssd1309_drawHLine(0, 61, 128, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_drawHLine(128)+flush");
+
+	ssd1309_drawVLine(127, 16, 48, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_drawVLine(48)+flush");
+
+	ssd1309_drawLine(0, 16, 127, 63, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_drawLine(128x48)+flush");
+
+	ssd1309_fillRect(8, 19, 20, 10, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_fillRect(20x10)+flush");
+
+	ssd1309_clearRect(10, 21, 16, 6);
+	ssd1309_flush();
+	report("ssd1309_clearRect(16x6)+flush");
+
+	ssd1309_drawRect(4, 17, 28, 14, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_drawRect(28x14)+flush");
+
+	ssd1309_drawRoundRect(34, 17, 28, 14, 4, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_drawRoundRect(28x14)+flush");
+
+	ssd1309_drawCircle(76, 40, 10, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_drawCircle(r=10)+flush");
+
+	ssd1309_fillCircle(100, 40, 10, SSD1309_WHITE);
+	ssd1309_flush();
+	report("ssd1309_fillCircle(r=10)+flush");
+
+	ssd1309_blit(testPic, 32, 16, 40, 35, SSD1309_ROP_XOR);
+	ssd1309_flush();
+	report("ssd1309_blit(32x16, y+3)+flush");
+#endif
+
+#ifdef SSD1309_STRIP
+	ssd1309_renderStrips(drawStrip);
+	sprintf(name, "ssd1309_renderStrips(%u page strips)", SSD1309_STRIP_PAGES);
+	report(name);
+#endif
+
+	cmd_ContrastControl(0x80);
+	report("cmd_ContrastControl()");
+
+	ssd1309_scroll_horizontal(SSD1309_SCROLL_LEFT, 0, 1, 0, 127, SSD1309_SCROLL_2FRAMES);
+	report("ssd1309_scroll_horizontal()");
+
+	ssd1309_scroll_stop();
+	report("ssd1309_scroll_stop()");
+
+	ssd1309_scroll_step(SSD1309_SCROLL_LEFT, 0, 1, 0, 127);
+	report("ssd1309_scroll_step()");
+
+	ssd1309_scroll_area(0, SSD1309_ROW);
+	report("ssd1309_scroll_area()");
+
+	ssd1309_scroll_diagonal(SSD1309_SCROLL_RIGHT, 0, 1, 0, 127, SSD1309_SCROLL_2FRAMES, 1);
+	report("ssd1309_scroll_diagonal()");
+
+	ssd1309_scroll_stop();
+	report("ssd1309_scroll_stop(diagonal)");
+
+#ifdef SSD1309_FRAMEBUFFER
+	ssd1309_flush();
+	report("ssd1309_flush()");
+
+	fb = ssd1309_getFramebuffer();			// invert the first text line in the buffer
+	for(i=0;i<66;i++)
+	{
+		fb[i] ^= 0xFF;
+	}
+	ssd1309_markDirty(0, 0, 65);
+	report("ssd1309_markDirty()");
+
+	sprintf(name, "ssd1309_flushBytes() = %u", ssd1309_flushBytes());
+	report(name);
+
+	ssd1309_flush_begin();
+	report("ssd1309_flush_begin()");
+
+	for(calls=1;!ssd1309_flush_step(16);calls++);
+	sprintf(name, "ssd1309_flush_step(16, %u calls)", calls);
+	report(name);
+#endif
+
+#ifdef SSD1309_CANVAS
+	ssd1309_panel_init(&second, 1, secondBuffer);
+	ssd1309_panel_select(&second);
+	ssd1309_init();
+	ssd1309_panel_select(&panel);
+	ssd1309_sim_resetStats();
+	ssd1309_panel_select(&second);
+	report("ssd1309_panel_select()");
+
+	ssd1309_canvas_draw(canvas, 2, drawCanvas);
+	report("ssd1309_canvas_draw(2 panels)");
+
+	ssd1309_canvas_flush(canvas, 2, 64);
+	report("ssd1309_canvas_flush(2 panels, 64)");
+
+	ssd1309_panel_select(&panel);			// -p prints the first panel
+#endif
+
+	if ((argc > 1) && (strcmp(argv[1], "-p") == 0))
+	{
+		ssd1309_sim_print();
+	}
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file	ssd1309_rle.c
+ * @brief	Host-side encoder for the compressed pictures of ssd1309_showPicRLE().
+ *
+ * Reads the hex bytes (0x..) of an Image2GLCD array ("LSB to MSB Top to Bottom") and
+ * writes the compressed picture as a C array.
+ *
+ *   gcc tools/ssd1309_rle.c -o ssd1309_rle
+ *   ./ssd1309_rle <width> <height> <name> < picture.c > picture_rle.c
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssd1309_rle.h"
+
+static unsigned char raw[255*255];
+static unsigned char out[2 + 2*255*255];
+static unsigned char check[255*255];
+
+/**
+  * @brief  decodes out[] into check[] the way the driver does, returns the number of bytes
+  */
+static size_t decode(size_t size)
+{
+	size_t pos = 2, len = 0, n;
+	unsigned char token;
+
+	while (pos < size)
+	{
+		token = out[pos++];
+		if (token < RLE_ZEROS)
+		{
+			n = token + 1;
+			memcpy(&check[len], &out[pos], n);
+			pos += n;
+		}
+		else
+		{
+			n = (token & 0x3F) + 1;
+			memset(&check[len], (token < RLE_RUN) ? 0x00 : out[pos++], n);
+		}
+		len += n;
+	}
+	return len;
+}
+
+int main(int argc, char *argv[])
+{
+	int width, height;
+	size_t len, need, size;
+
+	if (argc != 4)
+	{
+		fprintf(stderr, "usage: %s <width> <height> <name> < picture.c > picture_rle.c\n", argv[0]);
+		return 1;
+	}
+	width = atoi(argv[1]);
+	height = atoi(argv[2]);
+	if ((width < 1) || (width > 255) || (height < 1) || (height > 255*8))
+	{
+		fprintf(stderr, "width must be 1-255, height 1-%d\n", 255*8);
+		return 1;
+	}
+	need = (size_t)width * ((height+7)/8);
+	len = rleReadArray(stdin, raw, need);
+	if (len != need)
+	{
+		fprintf(stderr, "%s bytes in the input, %lu expected\n", (len > need) ? "more" : "less", (unsigned long)need);
+		return 1;
+	}
+
+	size = rleEncode(raw, (unsigned char)width, (unsigned char)((height+7)/8), out);
+	if ((decode(size) != len) || (memcmp(check, raw, len) != 0))
+	{
+		fprintf(stderr, "internal error, the decoded picture differs\n");
+		return 1;
+	}
+
+	printf("// %dx%d, %lu bytes compressed to %lu\n", width, height, (unsigned long)len, (unsigned long)size);
+	rlePrintArray(argv[3], out, size);
+	return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file	ssd1309_rle.h
+ * @brief	Run length encoder of the host tools, the format of ssd1309_showPicRLE().
+ *
+ * @license creative commons license CC BY-NC 4.0 http://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef SSD1309_RLE_H
+#define SSD1309_RLE_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define RLE_LITERAL		0x00		// same token values as SSD1309.h
+#define RLE_ZEROS		0x80
+#define RLE_RUN			0xC0
+#define RLE_MAX_LITERAL	128
+#define RLE_MAX_RUN		64
+
+/**
+  * @brief  returns the length of the run of equal bytes at pos, at most RLE_MAX_RUN
+  */
+static size_t rleRunLength(const unsigned char *raw, size_t pos, size_t len)
+{
+	size_t n = 1;
+
+	while ((pos+n < len) && (n < RLE_MAX_RUN) && (raw[pos+n] == raw[pos]))
+	{
+		n++;
+	}
+	return n;
+}
+
+/**
+  * @brief  returns true if a run token is shorter than literal bytes, a zero run costs one
+  *			byte and any other run two bytes, ending a literal costs one more byte
+  */
+static int rleTakeRun(const unsigned char *raw, size_t pos, size_t len, size_t literal)
+{
+	size_t n = rleRunLength(raw, pos, len);
+	size_t cost = (raw[pos] == 0x00) ? 1 : 2;
+
+	return n > (cost + (literal ? 1 : 0) - 1);
+}
+
+/**
+  * @brief  compresses a picture
+  *
+  * @param	*raw	the picture bytes, page after page
+  * @param  width	width of the picture, 1-255
+  * @param  pages	number of pages, 1-255
+  * @param  *out	the compressed picture, header included, at most 2 + 2*width*pages bytes
+  * @return	size of the compressed picture
+  */
+static size_t rleEncode(const unsigned char *raw, unsigned char width, unsigned char pages, unsigned char *out)
+{
+	size_t len = (size_t)width * pages;
+	size_t pos = 0, size = 2, start = 0, literal = 0, n;
+
+	out[0] = width;
+	out[1] = pages;
+	while (pos < len)
+	{
+		if (rleTakeRun(raw, pos, len, literal))
+		{
+			if (literal)
+			{
+				out[start] = (unsigned char)(RLE_LITERAL + literal - 1);
+				literal = 0;
+			}
+			n = rleRunLength(raw, pos, len);
+			if (raw[pos] == 0x00)
+			{
+				out[size++] = (unsigned char)(RLE_ZEROS + n - 1);
+			}
+			else
+			{
+				out[size++] = (unsigned char)(RLE_RUN + n - 1);
+				out[size++] = raw[pos];
+			}
+			pos += n;
+			continue;
+		}
+		if (literal == 0)
+		{
+			start = size++;					// the token is written when the literal ends
+		}
+		out[size++] = raw[pos++];
+		if (++literal == RLE_MAX_LITERAL)
+		{
+			out[start] = (unsigned char)(RLE_LITERAL + literal - 1);
+			literal = 0;
+		}
+	}
+	if (literal)
+	{
+		out[start] = (unsigned char)(RLE_LITERAL + literal - 1);
+	}
+	return size;
+}
+
+/**
+  * @brief  reads the 0x.. numbers of an Image2GLCD array, everything else is skipped
+  *
+  * @param	*file	the input
+  * @param  *raw	the picture bytes
+  * @param  max		size of raw
+  * @return	number of bytes read, max + 1 if there are more
+  */
+static size_t rleReadArray(FILE *file, unsigned char *raw, size_t max)
+{
+	size_t len = 0;
+	unsigned int value;
+	int c;
+
+	while ((c = getc(file)) != EOF)
+	{
+		if ((c == '0') && (((c = getc(file)) == 'x') || (c == 'X')) && (fscanf(file, "%x", &value) == 1))
+		{
+			if (len == max)
+			{
+				return max + 1;
+			}
+			raw[len++] = (unsigned char)value;
+		}
+	}
+	return len;
+}
+
+/**
+  * @brief  prints a byte array as C source
+  */
+static void rlePrintArray(const char *name, const unsigned char *data, size_t size)
+{
+	size_t i;
+
+	printf("const UINT8 %s[%lu] =\n{", name, (unsigned long)size);
+	for(i=0;i<size;i++)
+	{
+		printf("%s0x%02X%s", (i%16) ? "" : "\n\t", data[i], (i+1 < size) ? "," : "");
+	}
+	printf("\n};\n");
+}
+
+#endif /* SSD1309_RLE_H */